@@ -0,0 +1,72 @@
+//
+//  argument_exception_benchmark.cpp
+//  integral
+//
+// MIT License
+//
+// Copyright (c) 2024 André Pereira Henriques (aphenriques (at) outlook (dot) com)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include <cstddef>
+#include <memory>
+#include <string>
+
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#include <catch2/catch.hpp>
+#include <integral/integral.hpp>
+
+namespace {
+    // speculative conversion: the exception message is not used
+    bool isInteger(lua_State *luaState, int index) {
+        try {
+            integral::get<int>(luaState, index);
+            return true;
+        } catch (const integral::ArgumentException &) {
+            return false;
+        }
+    }
+
+    std::size_t getMessageLength(lua_State *luaState, int index) {
+        try {
+            integral::get<int>(luaState, index);
+            return 0;
+        } catch (const integral::ArgumentException &argumentException) {
+            return std::char_traits<char>::length(argumentException.what());
+        }
+    }
+}
+
+// ArgumentException formats its message (debug info lookup and string building) on the first call to what()
+TEST_CASE("argument exception") {
+    std::unique_ptr<lua_State, decltype(&lua_close)> luaState(luaL_newstate(), &lua_close);
+    REQUIRE(luaState.get() != nullptr);
+    lua_State * const luaStatePointer = luaState.get();
+    lua_pushstring(luaStatePointer, "not an integer");
+    // stack: string
+    BENCHMARK("failed probe") {
+        return isInteger(luaStatePointer, -1);
+    };
+    BENCHMARK("failed probe with message") {
+        return getMessageLength(luaStatePointer, -1);
+    };
+    lua_pop(luaStatePointer, 1);
+    REQUIRE(lua_gettop(luaStatePointer) == 0);
+}
@@ -0,0 +1,125 @@
+//
+//  compact_userdata_benchmark.cpp
+//  integral
+//
+// MIT License
+//
+// Copyright (c) 2024 André Pereira Henriques (aphenriques (at) outlook (dot) com)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <cstddef>
+#include <memory>
+
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#include <catch2/catch.hpp>
+#include <integral/integral.hpp>
+
+namespace {
+    constexpr int keNumberOfObjects = 100000;
+
+    class RegularVector {
+    public:
+        double x_;
+        double y_;
+
+        RegularVector(double x, double y) : x_(x), y_(y) {}
+    };
+
+    class CompactVector final {
+    public:
+        double x_;
+        double y_;
+
+        CompactVector(double x, double y) : x_(x), y_(y) {}
+    };
+
+    std::size_t getMemoryInUse(lua_State *luaState) {
+        lua_gc(luaState, LUA_GCCOLLECT, 0);
+        return static_cast<std::size_t>(lua_gc(luaState, LUA_GCCOUNT, 0))*1024 + static_cast<std::size_t>(lua_gc(luaState, LUA_GCCOUNTB, 0));
+    }
+
+    // stack: table (keNumberOfObjects objects)
+    template<typename T>
+    void pushObjects(lua_State *luaState) {
+        lua_createtable(luaState, keNumberOfObjects, 0);
+        for (int i = 1; i <= keNumberOfObjects; ++i) {
+            integral::push<T>(luaState, 1.0, 2.0);
+            lua_rawseti(luaState, -2, i);
+        }
+    }
+
+    // bytes allocated by lua per object (table slots excluded)
+    template<typename T>
+    double getMemoryPerObject(lua_State *luaState) {
+        lua_createtable(luaState, keNumberOfObjects, 0);
+        const std::size_t tableMemory = getMemoryInUse(luaState);
+        lua_pop(luaState, 1);
+        pushObjects<T>(luaState);
+        const double memoryPerObject = static_cast<double>(getMemoryInUse(luaState) - tableMemory)/keNumberOfObjects;
+        lua_pop(luaState, 1);
+        lua_gc(luaState, LUA_GCCOLLECT, 0);
+        return memoryPerObject;
+    }
+}
+
+template<>
+class integral::CompactUserData<CompactVector> : public std::true_type {};
+
+// compact userdata: no vtable pointer (UserDataWrapperBase), no uservalue (lua 5.4), no alignment padding and no __gc (not included in lua finalizer list)
+TEST_CASE("compact userdata") {
+    std::unique_ptr<lua_State, decltype(&lua_close)> luaState(luaL_newstate(), &lua_close);
+    REQUIRE(luaState.get() != nullptr);
+    lua_State * const luaStatePointer = luaState.get();
+    // registers the class metatables before measuring
+    integral::push<RegularVector>(luaStatePointer, 0.0, 0.0);
+    integral::push<CompactVector>(luaStatePointer, 0.0, 0.0);
+    lua_pop(luaStatePointer, 2);
+    const double regularMemoryPerObject = getMemoryPerObject<RegularVector>(luaStatePointer);
+    const double compactMemoryPerObject = getMemoryPerObject<CompactVector>(luaStatePointer);
+    WARN("memory per object - regular: " << regularMemoryPerObject << " bytes; compact: " << compactMemoryPerObject << " bytes; saved: " << regularMemoryPerObject - compactMemoryPerObject << " bytes");
+    REQUIRE(compactMemoryPerObject < regularMemoryPerObject);
+    BENCHMARK("push - regular") {
+        pushObjects<RegularVector>(luaStatePointer);
+        lua_pop(luaStatePointer, 1);
+        return lua_gettop(luaStatePointer);
+    };
+    BENCHMARK("push - compact") {
+        pushObjects<CompactVector>(luaStatePointer);
+        lua_pop(luaStatePointer, 1);
+        return lua_gettop(luaStatePointer);
+    };
+    // push plus a full collection of keNumberOfObjects unreachable objects (finalizers are called for regular objects)
+    // the collection time is the difference from the push benchmarks
+    BENCHMARK_ADVANCED("collect garbage - regular")(Catch::Benchmark::Chronometer meter) {
+        meter.measure([luaStatePointer] {
+            pushObjects<RegularVector>(luaStatePointer);
+            lua_pop(luaStatePointer, 1);
+            lua_gc(luaStatePointer, LUA_GCCOLLECT, 0);
+        });
+    };
+    BENCHMARK_ADVANCED("collect garbage - compact")(Catch::Benchmark::Chronometer meter) {
+        meter.measure([luaStatePointer] {
+            pushObjects<CompactVector>(luaStatePointer);
+            lua_pop(luaStatePointer, 1);
+            lua_gc(luaStatePointer, LUA_GCCOLLECT, 0);
+        });
+    };
+    REQUIRE(lua_gettop(luaStatePointer) == 0);
+}
@@ -0,0 +1,54 @@
+//
+//  container_view_benchmark.cpp
+//  integral
+//
+// MIT License
+//
+// Copyright (c) 2024 André Pereira Henriques (aphenriques (at) outlook (dot) com)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include <vector>
+
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#include <catch2/catch.hpp>
+#include <integral/integral.hpp>
+
+// a ContainerView is pushed without copying the container (a single userdata); each element access from lua is a metamethod call
+TEST_CASE("container view") {
+    integral::State luaState;
+    std::vector<double> vector(100000, 1.0);
+    BENCHMARK("push table copy") {
+        luaState["values"] = vector;
+    };
+    BENCHMARK("push view") {
+        luaState["values"] = integral::ContainerView(vector);
+    };
+    luaState["values"] = vector;
+    BENCHMARK("lua element read - table copy") {
+        luaState.doString("local x = values[1] + values[#values]");
+    };
+    luaState["values"] = integral::ContainerView(vector);
+    BENCHMARK("lua element read - view") {
+        luaState.doString("local x = values[1] + values[#values]");
+    };
+    luaState.doString("values = nil");
+    REQUIRE(lua_gettop(luaState.getLuaState()) == 0);
+}
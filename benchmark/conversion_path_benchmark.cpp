@@ -0,0 +1,104 @@
+//
+//  conversion_path_benchmark.cpp
+//  integral
+//
+// MIT License
+//
+// Copyright (c) 2024 André Pereira Henriques (aphenriques (at) outlook (dot) com)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include <cstddef>
+#include <memory>
+
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#include <catch2/catch.hpp>
+#include <integral/integral.hpp>
+
+namespace {
+    // Link<N> -> Link<N - 1> -> ... -> Link<0>
+    template<std::size_t N>
+    class Link : public Link<N - 1> {};
+
+    template<>
+    class Link<0> {
+    public:
+        int value_ = 1;
+    };
+
+    template<std::size_t N>
+    void defineChain(integral::StateView &stateView) {
+        if constexpr (N > 0) {
+            stateView.defineInheritance<Link<N>, Link<N - 1>>();
+            defineChain<N - 1>(stateView);
+        }
+    }
+
+    // stack: conversionPath (table of type function closures)
+    // the path the conversion took before the native ConversionPath (one lua_call per type function)
+    template<typename T>
+    void pushLuaConversionPath(lua_State *luaState, int index) {
+        lua_newtable(luaState);
+        lua_getmetatable(luaState, index);
+        REQUIRE(integral::detail::type_manager::searchConversionPath(luaState, integral::detail::TypeKey<T>::get(), lua_gettop(luaState) - 1) == true);
+    }
+}
+
+// both benchmarks exclude exchanger::getObject InlineCache
+// "lua closures" applies the type function closures of the resolved conversion path with lua_call
+// "native" is type_manager::getConvertibleType (conversion path cache lookup and a C++ loop over TypeFunctions)
+TEST_CASE("conversion path chain length") {
+    std::unique_ptr<lua_State, decltype(&lua_close)> luaState(luaL_newstate(), &lua_close);
+    REQUIRE(luaState.get() != nullptr);
+    lua_State * const luaStatePointer = luaState.get();
+    integral::StateView stateView(luaStatePointer);
+    defineChain<6>(stateView);
+    integral::push<Link<6>>(luaStatePointer);
+    // stack: link6
+    bool isConstantOffset;
+    pushLuaConversionPath<Link<5>>(luaStatePointer, 1);
+    // stack: link6 | conversionPath1
+    BENCHMARK("chain length 1 - lua closures") {
+        return static_cast<Link<5> *>(integral::detail::type_manager::applyConversionPathFunctions(luaStatePointer, 1, isConstantOffset))->value_;
+    };
+    BENCHMARK("chain length 1 - native") {
+        return integral::detail::type_manager::getConvertibleType<Link<5>>(luaStatePointer, 1)->value_;
+    };
+    lua_pop(luaStatePointer, 1);
+    pushLuaConversionPath<Link<3>>(luaStatePointer, 1);
+    // stack: link6 | conversionPath3
+    BENCHMARK("chain length 3 - lua closures") {
+        return static_cast<Link<3> *>(integral::detail::type_manager::applyConversionPathFunctions(luaStatePointer, 1, isConstantOffset))->value_;
+    };
+    BENCHMARK("chain length 3 - native") {
+        return integral::detail::type_manager::getConvertibleType<Link<3>>(luaStatePointer, 1)->value_;
+    };
+    lua_pop(luaStatePointer, 1);
+    pushLuaConversionPath<Link<0>>(luaStatePointer, 1);
+    // stack: link6 | conversionPath6
+    BENCHMARK("chain length 6 - lua closures") {
+        return static_cast<Link<0> *>(integral::detail::type_manager::applyConversionPathFunctions(luaStatePointer, 1, isConstantOffset))->value_;
+    };
+    BENCHMARK("chain length 6 - native") {
+        return integral::detail::type_manager::getConvertibleType<Link<0>>(luaStatePointer, 1)->value_;
+    };
+    lua_pop(luaStatePointer, 2);
+    REQUIRE(lua_gettop(luaStatePointer) == 0);
+}
@@ -0,0 +1,69 @@
+//
+//  default_argument_benchmark.cpp
+//  integral
+//
+// MIT License
+//
+// Copyright (c) 2024 André Pereira Henriques (aphenriques (at) outlook (dot) com)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include <memory>
+#include <string>
+
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#include <catch2/catch.hpp>
+#include <integral/integral.hpp>
+
+namespace {
+    class Object {
+    public:
+        std::string id_;
+
+        Object(const std::string &id) : id_(id) {}
+    };
+
+    std::size_t getLength(const std::string &string, const Object &object) {
+        return string.length() + object.id_.length();
+    }
+
+    // stack: function (it is not popped)
+    double callFunction(lua_State *luaState) {
+        lua_pushvalue(luaState, -1);
+        lua_call(luaState, 0, 1);
+        const double result = lua_tonumber(luaState, -1);
+        lua_pop(luaState, 1);
+        return result;
+    }
+}
+
+// default arguments are copied from upvalues (lua_pushvalue): no std::string or userdata is created per call
+TEST_CASE("default argument") {
+    std::unique_ptr<lua_State, decltype(&lua_close)> luaState(luaL_newstate(), &lua_close);
+    REQUIRE(luaState.get() != nullptr);
+    lua_State * const luaStatePointer = luaState.get();
+    integral::pushFunction(luaStatePointer, getLength, integral::DefaultArgument<std::string, 1>("default string"), integral::DefaultArgument<Object, 2>("default object"));
+    // stack: getLength
+    BENCHMARK("missing arguments") {
+        return callFunction(luaStatePointer);
+    };
+    lua_pop(luaStatePointer, 1);
+    REQUIRE(lua_gettop(luaStatePointer) == 0);
+}
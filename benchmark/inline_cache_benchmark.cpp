@@ -0,0 +1,104 @@
+//
+//  inline_cache_benchmark.cpp
+//  integral
+//
+// MIT License
+//
+// Copyright (c) 2024 André Pereira Henriques (aphenriques (at) outlook (dot) com)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include <memory>
+
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#include <catch2/catch.hpp>
+#include <integral/integral.hpp>
+
+namespace {
+    class Base {
+    public:
+        virtual ~Base() = default;
+
+        int base_ = 1;
+    };
+
+    class Derived : public Base {};
+
+    // inheritance is not defined: dynamic_cast fallback
+    class UndeclaredDerived : public Base {};
+
+    class Inner {
+    public:
+        int inner_ = 2;
+    };
+
+    class Outer {
+    public:
+        Inner inner_;
+    };
+}
+
+// "hit" benchmarks use integral::get (exchanger::getObject with its InlineCache)
+// "miss" benchmarks use exchanger::resolveObject without cache (the path taken on a cache miss)
+TEST_CASE("getObject inline cache") {
+    std::unique_ptr<lua_State, decltype(&lua_close)> luaState(luaL_newstate(), &lua_close);
+    REQUIRE(luaState.get() != nullptr);
+    lua_State * const luaStatePointer = luaState.get();
+    integral::StateView stateView(luaStatePointer);
+    stateView.defineInheritance<Derived, Base>();
+    stateView.defineInheritance([](Outer *outer) -> Inner * {
+        return &outer->inner_;
+    });
+    integral::push<Base>(luaStatePointer);
+    integral::push<Derived>(luaStatePointer);
+    integral::push<UndeclaredDerived>(luaStatePointer);
+    integral::push<Outer>(luaStatePointer);
+    // stack: base | derived | undeclaredDerived | outer
+    BENCHMARK("direct argument - hit") {
+        return integral::get<Base>(luaStatePointer, 1).base_;
+    };
+    BENCHMARK("direct argument - miss") {
+        return integral::detail::exchanger::resolveObject<Base>(luaStatePointer, 1, nullptr).base_;
+    };
+    BENCHMARK("inherited argument - hit") {
+        return integral::get<Base>(luaStatePointer, 2).base_;
+    };
+    BENCHMARK("inherited argument - miss") {
+        return integral::detail::exchanger::resolveObject<Base>(luaStatePointer, 2, nullptr).base_;
+    };
+#if INTEGRAL_WITH_RTTI
+    BENCHMARK("undeclared inherited argument (dynamic_cast) - hit") {
+        return integral::get<Base>(luaStatePointer, 3).base_;
+    };
+    // the dynamic_cast offset is memoized in the conversion path cache
+    BENCHMARK("undeclared inherited argument (dynamic_cast) - miss") {
+        return integral::detail::exchanger::resolveObject<Base>(luaStatePointer, 3, nullptr).base_;
+    };
+#endif
+    // custom type functions are not cached (the conversion might not be a constant offset)
+    BENCHMARK("synthetic inherited argument - hit") {
+        return integral::get<Inner>(luaStatePointer, 4).inner_;
+    };
+    BENCHMARK("synthetic inherited argument - miss") {
+        return integral::detail::exchanger::resolveObject<Inner>(luaStatePointer, 4, nullptr).inner_;
+    };
+    lua_pop(luaStatePointer, 4);
+    REQUIRE(lua_gettop(luaStatePointer) == 0);
+}
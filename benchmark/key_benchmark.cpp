@@ -0,0 +1,54 @@
+//
+//  key_benchmark.cpp
+//  integral
+//
+// MIT License
+//
+// Copyright (c) 2024 André Pereira Henriques (aphenriques (at) outlook (dot) com)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#include <catch2/catch.hpp>
+#include <integral/integral.hpp>
+
+// a string key is pushed with lua_pushlstring (hashed and interned on every access); an integral::Key is a single registry lookup (lua_rawgeti)
+TEST_CASE("key") {
+    integral::State luaState;
+    luaState.doString("configuration = {rendering = {maximumFramesPerSecond = 60}}");
+    BENCHMARK("string key reference get") {
+        return luaState["configuration"]["rendering"]["maximumFramesPerSecond"].get<int>();
+    };
+    const integral::Key configurationKey(luaState.getLuaState(), "configuration");
+    const integral::Key renderingKey(luaState.getLuaState(), "rendering");
+    const integral::Key maximumFramesPerSecondKey(luaState.getLuaState(), "maximumFramesPerSecond");
+    BENCHMARK("integral::Key reference get") {
+        return luaState[configurationKey][renderingKey][maximumFramesPerSecondKey].get<int>();
+    };
+    BENCHMARK("string key reference set") {
+        luaState["configuration"]["rendering"]["maximumFramesPerSecond"] = 30;
+        return lua_gettop(luaState.getLuaState());
+    };
+    BENCHMARK("integral::Key reference set") {
+        luaState[configurationKey][renderingKey][maximumFramesPerSecondKey] = 30;
+        return lua_gettop(luaState.getLuaState());
+    };
+    REQUIRE(lua_gettop(luaState.getLuaState()) == 0);
+}
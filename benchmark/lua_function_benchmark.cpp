@@ -0,0 +1,78 @@
+//
+//  lua_function_benchmark.cpp
+//  integral
+//
+// MIT License
+//
+// Copyright (c) 2024 André Pereira Henriques (aphenriques (at) outlook (dot) com)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include <algorithm>
+#include <functional>
+#include <vector>
+
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#include <catch2/catch.hpp>
+#include <integral/integral.hpp>
+
+// LuaFunction keeps the callee in a registry slot: a call is a single registry lookup plus lua_pcall (no path resolution and no reference string on errors)
+TEST_CASE("lua function") {
+    integral::State luaState;
+    luaState.doString("function getSum(x, y) return x + y end");
+    BENCHMARK("reference call") {
+        return luaState["getSum"].call<int>(1, 2);
+    };
+    integral::LuaFunction<int(int, int)> getSum = luaState["getSum"].get<integral::LuaFunction<int(int, int)>>();
+    BENCHMARK("lua function call") {
+        return getSum(1, 2);
+    };
+    std::function<int(int, int)> function = getSum;
+    BENCHMARK("std::function call") {
+        return function(1, 2);
+    };
+    REQUIRE(lua_gettop(luaState.getLuaState()) == 0);
+}
+
+// callUnprotected: no CallerException and no error message copy on lua error (the error value is raised again by the bound function)
+TEST_CASE("lua function argument") {
+    integral::State luaState;
+    luaState["sort"].setFunction([](std::vector<double> values, const integral::LuaFunctionArgument &compare) {
+        std::sort(values.begin(), values.end(), [&compare](double x, double y) {
+            return compare.call<bool>(x, y);
+        });
+        return values;
+    });
+    luaState["sortUnprotected"].setFunction([](std::vector<double> values, const integral::LuaFunctionArgument &compare) {
+        std::sort(values.begin(), values.end(), [&compare](double x, double y) {
+            return compare.callUnprotected<bool>(x, y);
+        });
+        return values;
+    });
+    luaState.doString("values = {} for i = 1, 1000 do values[i] = (i*7919) % 1000 end\n"
+                      "function compare(x, y) return x < y end");
+    BENCHMARK("call") {
+        luaState.doString("sort(values, compare)");
+    };
+    BENCHMARK("callUnprotected") {
+        luaState.doString("sortUnprotected(values, compare)");
+    };
+    REQUIRE(lua_gettop(luaState.getLuaState()) == 0);
+}
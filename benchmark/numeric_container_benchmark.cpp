@@ -0,0 +1,85 @@
+//
+//  numeric_container_benchmark.cpp
+//  integral
+//
+// MIT License
+//
+// Copyright (c) 2024 André Pereira Henriques (aphenriques (at) outlook (dot) com)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#include <catch2/catch.hpp>
+#include <integral/integral.hpp>
+
+namespace {
+    std::vector<double> getVector(std::size_t size) {
+        std::vector<double> vector(size);
+        for (std::size_t i = 0; i < size; ++i) {
+            vector[i] = 0.5*static_cast<double>(i);
+        }
+        return vector;
+    }
+
+    void benchmarkVector(lua_State *luaState, std::size_t size) {
+        const std::vector<double> vector = getVector(size);
+        const std::string sizeString = std::to_string(size);
+        BENCHMARK("push std::vector<double> - " + sizeString) {
+            integral::push<std::vector<double>>(luaState, vector);
+            lua_pop(luaState, 1);
+            return lua_gettop(luaState);
+        };
+        integral::push<std::vector<double>>(luaState, vector);
+        // stack: table
+        BENCHMARK("get std::vector<double> - " + sizeString) {
+            return integral::get<std::vector<double>>(luaState, -1).size();
+        };
+        lua_pop(luaState, 1);
+    }
+}
+
+// numeric elements are set with lua_rawseti and gotten with lua_rawgeti plus a direct number conversion (no exchanger dispatch and no exception handling per element)
+TEST_CASE("numeric container") {
+    std::unique_ptr<lua_State, decltype(&lua_close)> luaState(luaL_newstate(), &lua_close);
+    REQUIRE(luaState.get() != nullptr);
+    lua_State * const luaStatePointer = luaState.get();
+    benchmarkVector(luaStatePointer, 10);
+    benchmarkVector(luaStatePointer, 1000);
+    benchmarkVector(luaStatePointer, 1000000);
+    const std::array<double, 10> array{0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+    BENCHMARK("push std::array<double, 10>") {
+        integral::push<std::array<double, 10>>(luaStatePointer, array);
+        lua_pop(luaStatePointer, 1);
+        return lua_gettop(luaStatePointer);
+    };
+    integral::push<std::array<double, 10>>(luaStatePointer, array);
+    // stack: table
+    BENCHMARK("get std::array<double, 10>") {
+        return integral::get<std::array<double, 10>>(luaStatePointer, -1)[9];
+    };
+    lua_pop(luaStatePointer, 1);
+    REQUIRE(lua_gettop(luaStatePointer) == 0);
+}
@@ -0,0 +1,101 @@
+//
+//  overload_benchmark.cpp
+//  integral
+//
+// MIT License
+//
+// Copyright (c) 2024 André Pereira Henriques (aphenriques (at) outlook (dot) com)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include <memory>
+#include <string>
+
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#include <catch2/catch.hpp>
+#include <integral/integral.hpp>
+
+namespace {
+    class Vector {
+    public:
+        double x_;
+        double y_;
+
+        Vector(double x, double y) : x_(x), y_(y) {}
+    };
+
+    double addNumber(double x, double y) {
+        return x + y;
+    }
+
+    double addString(const std::string &x, double y) {
+        return static_cast<double>(x.length()) + y;
+    }
+
+    double addVector(const Vector &vector, double y) {
+        return vector.x_ + vector.y_ + y;
+    }
+
+    // stack: function | arguments... (pops arguments)
+    double callFunction(lua_State *luaState, int functionIndex, int nArguments) {
+        lua_pushvalue(luaState, functionIndex);
+        lua_insert(luaState, -1 - nArguments);
+        lua_call(luaState, nArguments, 1);
+        const double result = lua_tonumber(luaState, -1);
+        lua_pop(luaState, 1);
+        return result;
+    }
+}
+
+// single binding: LuaFunctionWrapper closure -> FunctionWrapper
+// overload: LuaFunctionWrapper closure -> argument count and Lua type masks -> function (objects: type manager check)
+TEST_CASE("overload") {
+    std::unique_ptr<lua_State, decltype(&lua_close)> luaState(luaL_newstate(), &lua_close);
+    REQUIRE(luaState.get() != nullptr);
+    lua_State * const luaStatePointer = luaState.get();
+    integral::pushFunction(luaStatePointer, addNumber);
+    integral::pushFunction(luaStatePointer, addVector);
+    integral::pushCopy(luaStatePointer, integral::overload(addString, addVector, addNumber));
+    integral::push<Vector>(luaStatePointer, 1.0, 2.0);
+    // stack: addNumber | addVector | add | vector
+    BENCHMARK("number - single binding") {
+        lua_pushnumber(luaStatePointer, 1.0);
+        lua_pushnumber(luaStatePointer, 2.0);
+        return callFunction(luaStatePointer, 1, 2);
+    };
+    // the last function of the overload set
+    BENCHMARK("number - overload") {
+        lua_pushnumber(luaStatePointer, 1.0);
+        lua_pushnumber(luaStatePointer, 2.0);
+        return callFunction(luaStatePointer, 3, 2);
+    };
+    BENCHMARK("object - single binding") {
+        lua_pushvalue(luaStatePointer, 4);
+        lua_pushnumber(luaStatePointer, 2.0);
+        return callFunction(luaStatePointer, 2, 2);
+    };
+    BENCHMARK("object - overload") {
+        lua_pushvalue(luaStatePointer, 4);
+        lua_pushnumber(luaStatePointer, 2.0);
+        return callFunction(luaStatePointer, 3, 2);
+    };
+    lua_pop(luaStatePointer, 4);
+    REQUIRE(lua_gettop(luaStatePointer) == 0);
+}
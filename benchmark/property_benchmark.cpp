@@ -0,0 +1,80 @@
+//
+//  property_benchmark.cpp
+//  integral
+//
+// MIT License
+//
+// Copyright (c) 2024 André Pereira Henriques (aphenriques (at) outlook (dot) com)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include <memory>
+
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#include <catch2/catch.hpp>
+#include <integral/integral.hpp>
+
+namespace {
+    class Vector {
+    public:
+        double x_;
+        double y_;
+
+        Vector(double x, double y) : x_(x), y_(y) {}
+    };
+
+    // stack: chunk (it is not popped)
+    double callChunk(lua_State *luaState) {
+        lua_pushvalue(luaState, -1);
+        lua_call(luaState, 0, 1);
+        const double result = lua_tonumber(luaState, -1);
+        lua_pop(luaState, 1);
+        return result;
+    }
+}
+
+// property access (vector.x) calls a single __index/__newindex metamethod; getter and setter calls (vector:getX()) look up the method and then call it
+TEST_CASE("property") {
+    std::unique_ptr<lua_State, decltype(&lua_close)> luaState(luaL_newstate(), &lua_close);
+    REQUIRE(luaState.get() != nullptr);
+    lua_State * const luaStatePointer = luaState.get();
+    integral::pushCopy(luaStatePointer, integral::ClassMetatable<Vector>()
+                                        .setConstructor<Vector(double, double)>("new")
+                                        .setGetter("getX", &Vector::x_)
+                                        .setSetter("setX", &Vector::x_)
+                                        .setGetter("getY", &Vector::y_)
+                                        .setProperty<&Vector::x_>("x")
+                                        .setProperty<&Vector::y_>("y"));
+    lua_setglobal(luaStatePointer, "Vector");
+    REQUIRE(luaL_dostring(luaStatePointer, "vector = Vector.new(0, 1)") == 0);
+    REQUIRE(luaL_loadstring(luaStatePointer, "for i = 1, 1000 do vector:setX(vector:getX() + vector:getY()) end return vector:getX()") == 0);
+    // stack: getterAndSetterChunk
+    BENCHMARK("getter and setter") {
+        return callChunk(luaStatePointer);
+    };
+    lua_pop(luaStatePointer, 1);
+    REQUIRE(luaL_loadstring(luaStatePointer, "for i = 1, 1000 do vector.x = vector.x + vector.y end return vector.x") == 0);
+    // stack: propertyChunk
+    BENCHMARK("property") {
+        return callChunk(luaStatePointer);
+    };
+    lua_pop(luaStatePointer, 1);
+    REQUIRE(lua_gettop(luaStatePointer) == 0);
+}
@@ -0,0 +1,85 @@
+//
+//  returns_benchmark.cpp
+//  integral
+//
+// MIT License
+//
+// Copyright (c) 2024 André Pereira Henriques (aphenriques (at) outlook (dot) com)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include <memory>
+#include <tuple>
+
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#include <catch2/catch.hpp>
+#include <integral/integral.hpp>
+
+namespace {
+    std::tuple<double, double, double> getPositionTuple() {
+        return {1.0, 2.0, 3.0};
+    }
+
+    integral::Returns<double, double, double> getPositionReturns() {
+        return {1.0, 2.0, 3.0};
+    }
+}
+
+// std::tuple: a lua table is created on every call (and collected later)
+// Returns: the values are pushed directly onto the stack
+TEST_CASE("multiple return values") {
+    std::unique_ptr<lua_State, decltype(&lua_close)> luaState(luaL_newstate(), &lua_close);
+    REQUIRE(luaState.get() != nullptr);
+    lua_State * const luaStatePointer = luaState.get();
+    integral::pushFunction<&getPositionTuple>(luaStatePointer);
+    integral::pushFunction<&getPositionReturns>(luaStatePointer);
+    // stack: getPositionTuple | getPositionReturns
+    BENCHMARK("std::tuple") {
+        lua_pushvalue(luaStatePointer, 1);
+        lua_call(luaStatePointer, 0, 1);
+        lua_rawgeti(luaStatePointer, -1, 3);
+        const double z = lua_tonumber(luaStatePointer, -1);
+        lua_pop(luaStatePointer, 2);
+        return z;
+    };
+    BENCHMARK("Returns") {
+        lua_pushvalue(luaStatePointer, 2);
+        lua_call(luaStatePointer, 0, 3);
+        const double z = lua_tonumber(luaStatePointer, -1);
+        lua_pop(luaStatePointer, 3);
+        return z;
+    };
+    lua_pop(luaStatePointer, 2);
+    REQUIRE(lua_gettop(luaStatePointer) == 0);
+}
+
+// std::tuple: the lua function returns a table, which is pushed again to get each element
+// Returns: the results are gotten from consecutive stack slots
+TEST_CASE("multiple results") {
+    integral::State luaState;
+    luaState.doString("function getPositionTable() return {1, 2, 3} end\n"
+                      "function getPosition() return 1, 2, 3 end");
+    BENCHMARK("std::tuple") {
+        return std::get<2>(luaState["getPositionTable"].call<std::tuple<double, double, double>>());
+    };
+    BENCHMARK("Returns") {
+        return std::get<2>(luaState["getPosition"].call<integral::Returns<double, double, double>>());
+    };
+}
@@ -0,0 +1,135 @@
+//
+//  static_function_benchmark.cpp
+//  integral
+//
+// MIT License
+//
+// Copyright (c) 2024 André Pereira Henriques (aphenriques (at) outlook (dot) com)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <memory>
+
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#include <catch2/catch.hpp>
+#include <integral/integral.hpp>
+
+namespace {
+    double getSum(double x, double y) {
+        return x + y;
+    }
+
+    // noexcept fast path (no try region)
+    double getNoexceptSum(double x, double y) noexcept {
+        return x + y;
+    }
+
+    class Object {
+    public:
+        double value_ = 1.0;
+
+        double getValue() const {
+            return value_;
+        }
+
+        double getNoexceptValue() const noexcept {
+            return value_;
+        }
+    };
+
+    // stack: function | arguments... (pops arguments)
+    double callFunction(lua_State *luaState, int functionIndex, int nArguments) {
+        lua_pushvalue(luaState, functionIndex);
+        lua_insert(luaState, -1 - nArguments);
+        lua_call(luaState, nArguments, 1);
+        const double result = lua_tonumber(luaState, -1);
+        lua_pop(luaState, 1);
+        return result;
+    }
+}
+
+// FunctionWrapper: lua_CFunction closure -> LuaFunctionWrapper userdata upvalue -> std::function -> std::function -> function
+// LuaFunctionWrapper: lua_CFunction closure -> LuaFunctionWrapper userdata upvalue (metatable is checked only if INTEGRAL_CHECKED) -> std::function -> function
+// StaticFunctionWrapper: stateless lua_CFunction -> function
+TEST_CASE("static function") {
+    std::unique_ptr<lua_State, decltype(&lua_close)> luaState(luaL_newstate(), &lua_close);
+    REQUIRE(luaState.get() != nullptr);
+    lua_State * const luaStatePointer = luaState.get();
+    integral::pushFunction(luaStatePointer, getSum);
+    integral::pushFunction<&getSum>(luaStatePointer);
+    integral::pushFunction(luaStatePointer, &Object::getValue);
+    integral::pushFunction<&Object::getValue>(luaStatePointer);
+    integral::push<Object>(luaStatePointer);
+    integral::pushLuaFunction(luaStatePointer, [](lua_State *lambdaLuaState) -> int {
+        lua_pushnumber(lambdaLuaState, lua_tonumber(lambdaLuaState, 1) + lua_tonumber(lambdaLuaState, 2));
+        return 1;
+    });
+    integral::pushFunction<&getNoexceptSum>(luaStatePointer);
+    integral::pushFunction<&Object::getNoexceptValue>(luaStatePointer);
+    // stack: getSum | staticGetSum | getValue | staticGetValue | object | luaGetSum | staticGetNoexceptSum | staticGetNoexceptValue
+    BENCHMARK("function - FunctionWrapper") {
+        lua_pushnumber(luaStatePointer, 1.0);
+        lua_pushnumber(luaStatePointer, 2.0);
+        return callFunction(luaStatePointer, 1, 2);
+    };
+    BENCHMARK("function - StaticFunctionWrapper") {
+        lua_pushnumber(luaStatePointer, 1.0);
+        lua_pushnumber(luaStatePointer, 2.0);
+        return callFunction(luaStatePointer, 2, 2);
+    };
+    BENCHMARK("noexcept function - StaticFunctionWrapper") {
+        lua_pushnumber(luaStatePointer, 1.0);
+        lua_pushnumber(luaStatePointer, 2.0);
+        return callFunction(luaStatePointer, 7, 2);
+    };
+    BENCHMARK("function - LuaFunctionWrapper") {
+        lua_pushnumber(luaStatePointer, 1.0);
+        lua_pushnumber(luaStatePointer, 2.0);
+        return callFunction(luaStatePointer, 6, 2);
+    };
+    BENCHMARK("method - FunctionWrapper") {
+        lua_pushvalue(luaStatePointer, 5);
+        return callFunction(luaStatePointer, 3, 1);
+    };
+    BENCHMARK("method - StaticFunctionWrapper") {
+        lua_pushvalue(luaStatePointer, 5);
+        return callFunction(luaStatePointer, 4, 1);
+    };
+    BENCHMARK("noexcept method - StaticFunctionWrapper") {
+        lua_pushvalue(luaStatePointer, 5);
+        return callFunction(luaStatePointer, 8, 1);
+    };
+    BENCHMARK("push - FunctionWrapper") {
+        integral::pushFunction(luaStatePointer, getSum);
+        lua_pop(luaStatePointer, 1);
+    };
+    // the LuaFunctionWrapper metatable is cached (no luaL_newmetatable name lookup)
+    BENCHMARK("push - LuaFunctionWrapper") {
+        integral::pushLuaFunction(luaStatePointer, [](lua_State *) -> int {
+            return 0;
+        });
+        lua_pop(luaStatePointer, 1);
+    };
+    BENCHMARK("push - StaticFunctionWrapper") {
+        integral::pushFunction<&getSum>(luaStatePointer);
+        lua_pop(luaStatePointer, 1);
+    };
+    lua_pop(luaStatePointer, 8);
+    REQUIRE(lua_gettop(luaStatePointer) == 0);
+}
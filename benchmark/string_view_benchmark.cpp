@@ -0,0 +1,64 @@
+//
+//  string_view_benchmark.cpp
+//  integral
+//
+// MIT License
+//
+// Copyright (c) 2024 André Pereira Henriques (aphenriques (at) outlook (dot) com)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#include <catch2/catch.hpp>
+#include <integral/integral.hpp>
+
+// a std::string argument (or Reference::get<std::string>) copies the lua string (heap allocation beyond small string optimization); std::string_view points to it
+TEST_CASE("string view") {
+    integral::State luaState;
+    luaState["text"] = std::string(256, 'x');
+    luaState["getStringLength"].setFunction([](const std::string &string) {
+        return string.size();
+    });
+    luaState["getStringViewLength"].setFunction([](std::string_view string) {
+        return string.size();
+    });
+    luaState.doString("local function getLengths(f) local n = 0; for i = 1, 1000 do n = n + f(text) end; return n end\n"
+                      "function getStringLengths() return getLengths(getStringLength) end\n"
+                      "function getStringViewLengths() return getLengths(getStringViewLength) end");
+    BENCHMARK("std::string argument - 1000 calls") {
+        return luaState["getStringLengths"].call<std::size_t>();
+    };
+    BENCHMARK("std::string_view argument - 1000 calls") {
+        return luaState["getStringViewLengths"].call<std::size_t>();
+    };
+    BENCHMARK("Reference::get<std::string>") {
+        return luaState["text"].get<std::string>().size();
+    };
+    BENCHMARK("Reference::with<std::string_view>") {
+        return luaState["text"].with<std::string_view>([](std::string_view string) {
+            return string.size();
+        });
+    };
+    REQUIRE(lua_gettop(luaState.getLuaState()) == 0);
+}
@@ -0,0 +1,80 @@
+//
+//  table_view_benchmark.cpp
+//  integral
+//
+// MIT License
+//
+// Copyright (c) 2024 André Pereira Henriques (aphenriques (at) outlook (dot) com)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#include <catch2/catch.hpp>
+#include <integral/integral.hpp>
+
+namespace {
+    void benchmarkTable(lua_State *luaState, std::size_t size) {
+        const std::string sizeString = std::to_string(size);
+        lua_newtable(luaState);
+        for (std::size_t i = 1; i <= size; ++i) {
+            lua_pushnumber(luaState, 0.5*static_cast<double>(i));
+            lua_rawseti(luaState, -2, static_cast<int>(i));
+        }
+        // stack: table
+        BENCHMARK("std::vector<double> element - " + sizeString) {
+            return integral::get<std::vector<double>>(luaState, -1)[size/2];
+        };
+        BENCHMARK("integral::TableView<> element - " + sizeString) {
+            return integral::get<integral::TableView<>>(luaState, -1).get<double>(size/2 + 1);
+        };
+        BENCHMARK("std::unordered_map<int, double> iteration - " + sizeString) {
+            double sum = 0.0;
+            for (const auto &[key, value] : integral::get<std::unordered_map<int, double>>(luaState, -1)) {
+                sum += value;
+            }
+            return sum;
+        };
+        BENCHMARK("integral::TableView<int, double> iteration - " + sizeString) {
+            double sum = 0.0;
+            for (const auto &[key, value] : integral::get<integral::TableView<int, double>>(luaState, -1)) {
+                sum += value;
+            }
+            return sum;
+        };
+        lua_pop(luaState, 1);
+    }
+}
+
+// TableView converts only the accessed elements (no table copy and no heap allocation)
+TEST_CASE("table view") {
+    std::unique_ptr<lua_State, decltype(&lua_close)> luaState(luaL_newstate(), &lua_close);
+    REQUIRE(luaState.get() != nullptr);
+    lua_State * const luaStatePointer = luaState.get();
+    benchmarkTable(luaStatePointer, 10);
+    benchmarkTable(luaStatePointer, 1000);
+    benchmarkTable(luaStatePointer, 100000);
+    REQUIRE(lua_gettop(luaStatePointer) == 0);
+}
@@ -4,6 +4,7 @@ INTEGRAL_LIB_ROOT_DIR:=lib
 INTEGRAL_LIB_DIR:=$(INTEGRAL_LIB_ROOT_DIR)/$(INTEGRAL)
 INTEGRAL_BIN_DIR:=samples
 INTEGRAL_TEST_DIR:=test
+INTEGRAL_BENCHMARK_DIR:=benchmark
 INTEGRAL_DEPENDENCIES_DIR:=dependencies
 INTEGRAL_STATIC_LIB:=lib$(INTEGRAL).a
 
@@ -25,8 +26,9 @@ else
 $(error Invalid parameter value)
 endif
 
+# OPTIMIZED=y defines NDEBUG: values created by integral itself are not validated at runtime (see lib/integral/checked.hpp)
 ifeq ($(OPTIMIZED), y)
-OPTIMIZATION_FLAGS:=-O3 -march=native -flto
+OPTIMIZATION_FLAGS:=-O3 -march=native -flto -DNDEBUG
 else ifeq ($(or $(OPTIMIZED), n), n)
 OPTIMIZATION_FLAGS:=-O0 -g
 else
@@ -51,6 +53,15 @@ else
 $(error Invalid parameter value)
 endif
 
+# WITH_RTTI=n: -fno-rtti (objects are only converted to base classes registered with integral; see lib/integral/rtti.hpp)
+ifeq ($(WITH_RTTI), n)
+RTTI_FLAG:=-fno-rtti
+else ifeq ($(or $(WITH_RTTI), y), y)
+RTTI_FLAG:=
+else
+$(error Invalid parameter value)
+endif
+
 ifeq ($(shell uname -s), Darwin)
 SHARED_LIB_EXTENSION:=dylib
 # INTEGRAL_SHARED_LIB is defined later. That's why = is used instead of :=
@@ -64,7 +75,7 @@ endif
 
 INTEGRAL_SHARED_LIB:=lib$(INTEGRAL).$(SHARED_LIB_EXTENSION)
 
-INTEGRAL_CXXFLAGS:=$(EXTRA_CXXFLAGS) -std=c++17 -Werror -Wall -Wextra -Wshadow -Wnon-virtual-dtor -pedantic $(OPTIMIZATION_FLAGS) $(SANITIZE_FLAGS) $(FPIC_FLAG)
+INTEGRAL_CXXFLAGS:=$(EXTRA_CXXFLAGS) -std=c++17 -Werror -Wall -Wextra -Wshadow -Wnon-virtual-dtor -pedantic $(OPTIMIZATION_FLAGS) $(SANITIZE_FLAGS) $(FPIC_FLAG) $(RTTI_FLAG)
 
 INTEGRAL_COMMON_LDFLAGS:=$(EXTRA_LDFLAGS) $(OPTIMIZATION_FLAGS) $(SANITIZE_FLAGS)
 INTEGRAL_SHARED_LDFLAGS:=$(INTEGRAL_COMMON_LDFLAGS) -shared $(INTEGRAL_DARWIN_SHARED_LDFLAGS)
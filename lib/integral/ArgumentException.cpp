@@ -27,23 +27,127 @@
 #include "ArgumentException.hpp"
 #include <cstddef>
 #include <cstring>
+#include <memory>
 #include <sstream>
+#include <string>
+#include <utility>
 #include <lua.hpp>
 #include "lua_compatibility.hpp"
 
 namespace integral {
+    // state-free facts of the exception (the lua state might be closed when the message is formatted)
+    class ArgumentException::Message {
+    public:
+        enum class Type {kFormatted, kArgument, kTypeError, kNumberOfArguments};
+
+        Type type_;
+        int index_ = 0;
+        // kFormatted: text; kArgument: extra message (prefix of the cause message, if any); kTypeError: expected type name
+        std::string extraMessage_;
+        int gottenTypeCode_ = LUA_TNONE;
+        // lua_typename returns a static string
+        const char *gottenTypeName_ = nullptr;
+        std::size_t maximumNumberOfArguments_ = 0;
+        std::size_t actualNumberOfArguments_ = 0;
+        std::shared_ptr<Message> cause_;
+
+        inline explicit Message(Type type);
+
+        // formatted on the first call (without the function name)
+        const std::string & getText();
+
+        // "luaState" == nullptr: without the function name
+        std::string getText(lua_State *luaState);
+
+    private:
+        bool isFormatted_ = false;
+        std::string text_;
+    };
+
+    inline ArgumentException::Message::Message(Type type) : type_(type) {}
+
+    const std::string & ArgumentException::Message::getText() {
+        if (isFormatted_ == false) {
+            text_ = getText(nullptr);
+            isFormatted_ = true;
+        }
+        return text_;
+    }
+
+    std::string ArgumentException::Message::getText(lua_State *luaState) {
+        switch (type_) {
+            case Type::kFormatted:
+                return extraMessage_;
+            case Type::kArgument:
+                return getExceptionMessage(luaState, index_, (cause_ != nullptr) ? extraMessage_ + cause_->getText() : extraMessage_);
+            case Type::kTypeError:
+                if (gottenTypeCode_ != LUA_TNUMBER || extraMessage_ != gottenTypeName_) {
+                    return getExceptionMessage(luaState, index_, extraMessage_ + " expected, got " + gottenTypeName_);
+                } else {
+                    return getExceptionMessage(luaState, index_, "integral number type expected, got floating-point number");
+                }
+            case Type::kNumberOfArguments:
+                return getExceptionMessage(luaState, maximumNumberOfArguments_, actualNumberOfArguments_);
+        }
+        return extraMessage_;
+    }
+
     // If a class is defined in a header file and has a vtable (either it has virtual methods or it derives from classes with virtual methods), it must always have at least one out-of-line virtual method in the class. Without this, the compiler will copy the vtable and RTTI into every .o file that #includes the header, bloating .o file sizes and increasing link times.
     // source: http://llvm.org/docs/CodingStandards.html#provide-a-virtual-method-anchor-for-classes-in-headers
     ArgumentException::~ArgumentException() {}
 
     ArgumentException ArgumentException::createTypeErrorException(lua_State *luaState, int index, const std::string &expectedTypeName) {
-        const int gottenTypeCode = lua_type(luaState, index);
-        const char * const gottenTypeName = lua_typename(luaState, gottenTypeCode);
-        if (gottenTypeCode != LUA_TNUMBER || expectedTypeName != gottenTypeName) {
-            return ArgumentException(luaState, index, expectedTypeName + " expected, got " + gottenTypeName);
-        } else {
-            return ArgumentException(luaState, index, "integral number type expected, got floating-point number");
+        std::shared_ptr<Message> message = std::make_shared<Message>(Message::Type::kTypeError);
+        message->index_ = index;
+        message->extraMessage_ = expectedTypeName;
+        // the type is gotten now: the stack might change before the message is formatted
+        message->gottenTypeCode_ = lua_type(luaState, index);
+        message->gottenTypeName_ = lua_typename(luaState, message->gottenTypeCode_);
+        return ArgumentException(std::move(message));
+    }
+
+    ArgumentException ArgumentException::createOverloadException(lua_State *luaState) {
+        // formatted now: the message includes the types of the arguments on the stack
+        std::shared_ptr<Message> message = std::make_shared<Message>(Message::Type::kFormatted);
+        message->extraMessage_ = getOverloadExceptionMessage(luaState);
+        return ArgumentException(std::move(message));
+    }
+
+    ArgumentException::ArgumentException(lua_State * /*luaState*/, int index, const std::string &extraMessage) : std::invalid_argument(""), message_(std::make_shared<Message>(Message::Type::kArgument)) {
+        message_->index_ = index;
+        message_->extraMessage_ = extraMessage;
+    }
+
+    ArgumentException::ArgumentException(lua_State * /*luaState*/, std::size_t maximumNumberOfArguments, std::size_t actualNumberOfArguments) : std::invalid_argument(""), message_(std::make_shared<Message>(Message::Type::kNumberOfArguments)) {
+        message_->maximumNumberOfArguments_ = maximumNumberOfArguments;
+        message_->actualNumberOfArguments_ = actualNumberOfArguments;
+    }
+
+    ArgumentException::ArgumentException(lua_State *luaState, int index, const std::string &extraMessage, const ArgumentException &cause) : ArgumentException(luaState, index, extraMessage) {
+        message_->cause_ = cause.message_;
+    }
+
+    ArgumentException::ArgumentException(std::shared_ptr<Message> &&message) : std::invalid_argument(""), message_(std::move(message)) {}
+
+    const char * ArgumentException::what() const noexcept {
+        if (message_ == nullptr) {
+            // moved exception
+            return std::invalid_argument::what();
+        }
+        try {
+            return message_->getText().c_str();
+        } catch (...) {
+            // std::bad_alloc
+            return "[integral] invalid argument";
+        }
+    }
+
+    std::string ArgumentException::getMessage(lua_State *luaState) const {
+        if (message_ == nullptr) {
+            // moved exception
+            return std::invalid_argument::what();
         }
+        return message_->getText(luaState);
     }
 
     bool ArgumentException::findField(lua_State *luaState, int index, int level) {
@@ -85,7 +189,7 @@ namespace integral {
 
     std::string ArgumentException::getExceptionMessage(lua_State *luaState, int index, const std::string &extraMessage) {
         lua_Debug debugInfo;
-        if (lua_getstack(luaState, 0, &debugInfo) == 0) {
+        if (luaState == nullptr || lua_getstack(luaState, 0, &debugInfo) == 0) {
             std::ostringstream messageStream;
             messageStream << "bad argument #" << index << " (" << extraMessage << ")";
             return messageStream.str();
@@ -99,17 +203,21 @@ namespace integral {
                 return messageStream.str();
             }
         }
+        // the global function name is popped after the message is formatted
+        const int top = lua_gettop(luaState);
         if (debugInfo.name == nullptr) {
             debugInfo.name = (pushGlobalFunctionName(luaState, &debugInfo) == true) ? lua_tostring(luaState, -1) : "?";
         }
         std::ostringstream messageStream;
         messageStream << "bad argument #" << index << " to '" <<  debugInfo.name << "' (" << extraMessage << ")";
-        return messageStream.str();
+        std::string message = messageStream.str();
+        lua_settop(luaState, top);
+        return message;
     }
 
     std::string ArgumentException::getExceptionMessage(lua_State *luaState, std::size_t maximumNumberOfArguments, std::size_t actualNumberOfArguments) {
         lua_Debug debugInfo;
-        if (lua_getstack(luaState, 0, &debugInfo) == 0) {
+        if (luaState == nullptr || lua_getstack(luaState, 0, &debugInfo) == 0) {
             std::ostringstream messageStream;
             messageStream << "excessive parameters provided to function (" << maximumNumberOfArguments << " expected, got " << actualNumberOfArguments << ")";
             return messageStream.str();
@@ -124,11 +232,42 @@ namespace integral {
             }
             return messageStream.str();
         }
+        // the global function name is popped after the message is formatted
+        const int top = lua_gettop(luaState);
         if (debugInfo.name == nullptr) {
             debugInfo.name = (pushGlobalFunctionName(luaState, &debugInfo) == true) ? lua_tostring(luaState, -1) : "?";
         }
         std::ostringstream messageStream;
         messageStream << "excessive parameters provided to function '" << debugInfo.name << "' (" << maximumNumberOfArguments << " expected, got " << actualNumberOfArguments << ")";
-        return messageStream.str();
+        std::string message = messageStream.str();
+        lua_settop(luaState, top);
+        return message;
+    }
+
+    std::string ArgumentException::getOverloadExceptionMessage(lua_State *luaState) {
+        // argument types are gotten before pushGlobalFunctionName changes the stack
+        std::ostringstream argumentTypesStream;
+        const int numberOfArguments = lua_gettop(luaState);
+        for (int index = 1; index <= numberOfArguments; ++index) {
+            if (index > 1) {
+                argumentTypesStream << ", ";
+            }
+            argumentTypesStream << luaL_typename(luaState, index);
+        }
+        lua_Debug debugInfo;
+        if (lua_getstack(luaState, 0, &debugInfo) == 0) {
+            return "no matching overload for argument types (" + argumentTypesStream.str() + ")";
+        }
+        lua_getinfo(luaState, "n", &debugInfo);
+        // the global function name is popped after the message is formatted
+        const int top = lua_gettop(luaState);
+        if (debugInfo.name == nullptr) {
+            debugInfo.name = (pushGlobalFunctionName(luaState, &debugInfo) == true) ? lua_tostring(luaState, -1) : "?";
+        }
+        std::ostringstream messageStream;
+        messageStream << "no matching overload of '" << debugInfo.name << "' for argument types (" << argumentTypesStream.str() << ")";
+        std::string message = messageStream.str();
+        lua_settop(luaState, top);
+        return message;
     }
 }
@@ -30,10 +30,13 @@
 #include <cstddef>
 #include <stdexcept>
 #include <exception>
+#include <memory>
 #include <string>
 #include <lua.hpp>
 
 namespace integral {
+    // The message is formatted on the first call to what(): a failed conversion only stores the stack index and the type names (no string building and no debug info lookup).
+    // The exception does not keep the lua state: what() does not include the name of the lua function. It is added by getMessage(luaState) in the frame of the function that threw the exception (exchanger::callLuaFunction)
     class ArgumentException : public std::invalid_argument {
     public:
         // necessary because of the user-defined destructor
@@ -46,22 +49,37 @@ namespace integral {
 
         static ArgumentException createTypeErrorException(lua_State *luaState, int index, const std::string &expectedTypeName);
 
-        inline ArgumentException(lua_State *luaState, int index, const std::string &extraMessage);
-        inline ArgumentException(lua_State *luaState, std::size_t maximumNumberOfArguments, std::size_t actualNumberOfArguments);
+        // no function of an overload set matches the arguments on the stack
+        static ArgumentException createOverloadException(lua_State *luaState);
+
+        ArgumentException(lua_State *luaState, int index, const std::string &extraMessage);
+        ArgumentException(lua_State *luaState, std::size_t maximumNumberOfArguments, std::size_t actualNumberOfArguments);
+
+        // "cause": exception of an element (e.g. table element or return value). The message is "extraMessage" followed by the "cause" message
+        ArgumentException(lua_State *luaState, int index, const std::string &extraMessage, const ArgumentException &cause);
+
+        // does not access the lua state
+        const char * what() const noexcept override;
+
+        // message with the name of the running lua function (the stack is restored)
+        // it must only be called in the frame of the lua function that threw the exception (see exchanger::callLuaFunction)
+        std::string getMessage(lua_State *luaState) const;
 
     private:
+        class Message;
+
+        // shared by copies: the message is formatted once
+        std::shared_ptr<Message> message_;
+
+        explicit ArgumentException(std::shared_ptr<Message> &&message);
+
         static bool findField(lua_State *luaState, int index, int level);
         static bool pushGlobalFunctionName(lua_State *L, lua_Debug *debugInfo);
+        // "luaState" == nullptr: message without the function name
         static std::string getExceptionMessage(lua_State *luaState, int index, const std::string &extraMessage);
         static std::string getExceptionMessage(lua_State *luaState, std::size_t maximumNumberOfArguments, std::size_t actualNumberOfArguments);
+        static std::string getOverloadExceptionMessage(lua_State *luaState);
     };
-
-    //--
-
-
-    inline ArgumentException::ArgumentException(lua_State *luaState, int index, const std::string &extraMessage) : std::invalid_argument(getExceptionMessage(luaState, index, extraMessage)) {}
-
-    inline ArgumentException::ArgumentException(lua_State *luaState, std::size_t maximumNumberOfArguments, std::size_t actualNumberOfArguments) : std::invalid_argument(getExceptionMessage(luaState, maximumNumberOfArguments, actualNumberOfArguments)) {}
 }
 
 
@@ -27,28 +27,56 @@
 #ifndef integral_Caller_hpp
 #define integral_Caller_hpp
 
+#include <cstddef>
 #include <stdexcept>
 #include <string>
 #include <type_traits>
+#include <utility>
 #include <lua.hpp>
 #include <exception/TemplateClassException.hpp>
 #include "ArgumentException.hpp"
 #include "exchanger.hpp"
 #include "generic.hpp"
 #include "IsStringLiteral.hpp"
+#include "LuaError.hpp"
+#include "Returns.hpp"
 
 namespace integral {
     namespace detail {
+        // Caller::call uses lua_pcall: lua errors are thrown as CallerException
+        // Caller::callUnprotected does not convert lua errors to CallerException (no error message copy): the error value is left on the stack and LuaError is thrown. It must only be called inside a function bound by integral, where exchanger::callLuaFunction raises the error value again unchanged after the C++ frames are unwound
         template<typename R, typename ...A>
         class Caller {
         public:
             static decltype(auto) call(lua_State *luaState, A &&...arguments);
+            static decltype(auto) callUnprotected(lua_State *luaState, A &&...arguments);
+
+        private:
+            // stack: result
+            static decltype(auto) getResult(lua_State *luaState);
         };
 
         template<typename ...A>
         class Caller<void, A...> {
         public:
             static void call(lua_State *luaState, A &&...arguments);
+            static void callUnprotected(lua_State *luaState, A &&...arguments);
+        };
+
+        // multiple results: requests sizeof...(T) results and gets them from consecutive stack slots (no table)
+        // elements are returned by value
+        template<typename ...T, typename ...A>
+        class Caller<Returns<T...>, A...> {
+        public:
+            static Returns<T...> call(lua_State *luaState, A &&...arguments);
+            static Returns<T...> callUnprotected(lua_State *luaState, A &&...arguments);
+
+        private:
+            // stack: result1 | result2 | ... | resultN
+            static Returns<T...> getResults(lua_State *luaState);
+
+            template<std::size_t ...S>
+            inline static Returns<T...> get(lua_State *luaState, std::index_sequence<S...>);
         };
 
         using CallerException = exception::TemplateClassException<Caller, std::runtime_error>;
@@ -59,15 +87,7 @@ namespace integral {
         decltype(auto) Caller<R, A...>::call(lua_State *luaState, A &&...arguments) {
             exchanger::pushCopy(luaState, std::forward<A>(arguments)...);
             if (lua_pcall(luaState, sizeof...(A), 1, 0) == lua_compatibility::keLuaOk) {
-                try {
-                    decltype(auto) returnValue = exchanger::get<R>(luaState, -1);
-                    lua_pop(luaState, 1);
-                    return returnValue;
-                } catch (const ArgumentException &argumentException) {
-                    // the number of results from lua_pcall is adjusted to 'nresults' argument
-                    lua_pop(luaState, 1);
-                    throw ArgumentException(luaState, -1, std::string("invalid return type: " ) + argumentException.what());
-                }
+                return getResult(luaState);
             } else {
                 std::string errorMessage(lua_tostring(luaState, -1));
                 lua_pop(luaState, 1);
@@ -75,6 +95,76 @@ namespace integral {
             }
         }
 
+        template<typename R, typename ...A>
+        decltype(auto) Caller<R, A...>::callUnprotected(lua_State *luaState, A &&...arguments) {
+            exchanger::pushCopy(luaState, std::forward<A>(arguments)...);
+            if (lua_pcall(luaState, sizeof...(A), 1, 0) == lua_compatibility::keLuaOk) {
+                return getResult(luaState);
+            } else {
+                // stack: error
+                throw LuaError(lua_gettop(luaState));
+            }
+        }
+
+        template<typename R, typename ...A>
+        decltype(auto) Caller<R, A...>::getResult(lua_State *luaState) {
+            try {
+                decltype(auto) returnValue = exchanger::get<R>(luaState, -1);
+                lua_pop(luaState, 1);
+                return returnValue;
+            } catch (const ArgumentException &argumentException) {
+                // the number of results from lua_pcall is adjusted to 'nresults' argument
+                lua_pop(luaState, 1);
+                throw ArgumentException(luaState, -1, "invalid return type: ", argumentException);
+            }
+        }
+
+        template<typename ...T, typename ...A>
+        Returns<T...> Caller<Returns<T...>, A...>::call(lua_State *luaState, A &&...arguments) {
+            constexpr int keNumberOfResults = static_cast<int>(sizeof...(T));
+            exchanger::pushCopy(luaState, std::forward<A>(arguments)...);
+            if (lua_pcall(luaState, sizeof...(A), keNumberOfResults, 0) == lua_compatibility::keLuaOk) {
+                return getResults(luaState);
+            } else {
+                std::string errorMessage(lua_tostring(luaState, -1));
+                lua_pop(luaState, 1);
+                throw CallerException(errorMessage);
+            }
+        }
+
+        template<typename ...T, typename ...A>
+        Returns<T...> Caller<Returns<T...>, A...>::callUnprotected(lua_State *luaState, A &&...arguments) {
+            exchanger::pushCopy(luaState, std::forward<A>(arguments)...);
+            if (lua_pcall(luaState, sizeof...(A), static_cast<int>(sizeof...(T)), 0) == lua_compatibility::keLuaOk) {
+                return getResults(luaState);
+            } else {
+                // stack: error
+                throw LuaError(lua_gettop(luaState));
+            }
+        }
+
+        template<typename ...T, typename ...A>
+        Returns<T...> Caller<Returns<T...>, A...>::getResults(lua_State *luaState) {
+            constexpr int keNumberOfResults = static_cast<int>(sizeof...(T));
+            try {
+                Returns<T...> returnValues = get(luaState, std::index_sequence_for<T...>());
+                lua_pop(luaState, keNumberOfResults);
+                return returnValues;
+            } catch (const ArgumentException &argumentException) {
+                // the number of results from lua_pcall is adjusted to 'nresults' argument
+                lua_pop(luaState, keNumberOfResults);
+                throw ArgumentException(luaState, -1, "invalid return type: ", argumentException);
+            }
+        }
+
+        template<typename ...T, typename ...A>
+        template<std::size_t ...S>
+        // [[maybe_unused]]: see FunctionCaller<void, A...>::call
+        inline Returns<T...> Caller<Returns<T...>, A...>::get([[maybe_unused]] lua_State *luaState, std::index_sequence<S...>) {
+            // stack: result1 | result2 | ... | resultN
+            return Returns<T...>(exchanger::get<T>(luaState, static_cast<int>(S) - static_cast<int>(sizeof...(T)))...);
+        }
+
         template<typename ...A>
         void Caller<void, A...>::call(lua_State *luaState, A &&...arguments) {
             exchanger::pushCopy(luaState, std::forward<A>(arguments)...);
@@ -84,6 +174,15 @@ namespace integral {
                 throw CallerException(errorMessage);
             }
         }
+
+        template<typename ...A>
+        void Caller<void, A...>::callUnprotected(lua_State *luaState, A &&...arguments) {
+            exchanger::pushCopy(luaState, std::forward<A>(arguments)...);
+            if (lua_pcall(luaState, sizeof...(A), 0, 0) != lua_compatibility::keLuaOk) {
+                // stack: error
+                throw LuaError(lua_gettop(luaState));
+            }
+        }
     }
 }
 
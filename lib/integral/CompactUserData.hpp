@@ -0,0 +1,41 @@
+//
+//  CompactUserData.hpp
+//  integral
+//
+// MIT License
+//
+// Copyright (c) 2024 André Pereira Henriques (aphenriques (at) outlook (dot) com)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef integral_CompactUserData_hpp
+#define integral_CompactUserData_hpp
+
+#include <type_traits>
+
+namespace integral {
+    // opt-in compact userdata layout:
+    //   template<> class integral::CompactUserData<Vector> : public std::true_type {};
+    // T objects are stored directly in the userdata block (T may be final): no vtable, no uservalue, no alignment padding (if alignof(T) fits lua userdata alignment) and no __gc metamethod
+    // T must be trivially destructible. Unregistered inheritance (dynamic_cast) is not available for compact types
+    template<typename T>
+    class CompactUserData : public std::false_type {};
+}
+
+#endif
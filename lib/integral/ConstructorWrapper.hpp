@@ -91,18 +91,20 @@ namespace integral {
             template<typename T, typename ...A, typename M>
             template<typename W>
             inline void Exchanger<ConstructorWrapper<T(A...), M>>::genericPush(lua_State *luaState, W &&constructorWrapper) {
+                // default arguments are stored as upvalues (see DefaultArgumentManager)
+                const int numberOfDefaultArguments = constructorWrapper.getDefaultArgumentManager().template pushDefaultArguments<A...>(luaState);
                 exchanger::push<LuaFunctionWrapper>(luaState, [lambdaConstructorWrapper = std::forward<W>(constructorWrapper)](lua_State *lambdaLuaState) -> int {
                     // replicate code of maximum number of parameters checking in Exchanger<FunctionWrapper<R(A...), M>>::push
                     const std::size_t numberOfArgumentsOnStack = static_cast<std::size_t>(lua_gettop(lambdaLuaState));
                     constexpr std::size_t keCppNumberOfArguments = sizeof...(A);
                     if (numberOfArgumentsOnStack <= keCppNumberOfArguments) {
-                        lambdaConstructorWrapper.getDefaultArgumentManager().processDefaultArguments(lambdaLuaState, keCppNumberOfArguments, numberOfArgumentsOnStack);
+                        lambdaConstructorWrapper.getDefaultArgumentManager().template processDefaultArguments<A...>(lambdaLuaState, keCppNumberOfArguments, numberOfArgumentsOnStack);
                         callConstructor(lambdaLuaState, std::make_index_sequence<keCppNumberOfArguments>());
                         return 1;
                     } else {
                         throw ArgumentException(lambdaLuaState, keCppNumberOfArguments, numberOfArgumentsOnStack);
                     }
-                });
+                }, numberOfDefaultArguments);
             }
 
             template<typename T, typename ...A, typename M>
@@ -0,0 +1,362 @@
+//
+//  ContainerView.hpp
+//  integral
+//
+// MIT License
+//
+// Copyright (c) 2024 André Pereira Henriques (aphenriques (at) outlook (dot) com)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#ifndef integral_ContainerView_hpp
+#define integral_ContainerView_hpp
+
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include <lua.hpp>
+#include "ArgumentException.hpp"
+#include "basic.hpp"
+#include "exchanger.hpp"
+#include "lua_compatibility.hpp"
+#include "Overload.hpp"
+#include "type_manager.hpp"
+
+namespace integral {
+    // Proxy to a std::vector, std::array or std::unordered_map pushed as userdata instead of a table copy.
+    // Lua code reads and writes the C++ container in place: view[key], view[key] = value, #view, pairs(view), ipairs(view), view:push_back(value) (std::vector) and view:erase(key) (std::vector and std::unordered_map)
+    // Sequence indices start with 1 (like lua). Assigning to index #view + 1 appends an element (std::vector); assigning nil to a std::unordered_map key erases it.
+    // Elements are pushed by value (like integral::push).
+    // A view constructed from a reference does not own the container: the container must outlive the view in lua. A view constructed from a std::shared_ptr shares its ownership.
+    // The container is also gotten as a copy by integral::get<C> (automatic synthetic inheritance, like std::shared_ptr)
+    // "C": container type
+    template<typename C>
+    class ContainerView {
+    public:
+        explicit inline ContainerView(C &container);
+        explicit inline ContainerView(std::shared_ptr<C> container);
+
+        inline C & get() const;
+
+    private:
+        std::shared_ptr<C> container_;
+    };
+
+    namespace detail {
+        template<typename C>
+        class ContainerViewTraits;
+
+        template<typename T, typename A>
+        class ContainerViewTraits<std::vector<T, A>> {
+        public:
+            static constexpr bool keIsSequence = true;
+            static constexpr bool keIsResizable = true;
+            using ValueType = T;
+        };
+
+        template<typename T, std::size_t N>
+        class ContainerViewTraits<std::array<T, N>> {
+        public:
+            static constexpr bool keIsSequence = true;
+            static constexpr bool keIsResizable = false;
+            using ValueType = T;
+        };
+
+        template<typename K, typename T, typename H, typename E, typename A>
+        class ContainerViewTraits<std::unordered_map<K, T, H, E, A>> {
+        public:
+            static constexpr bool keIsSequence = false;
+            static constexpr bool keIsResizable = false;
+            using KeyType = K;
+            using ValueType = T;
+        };
+
+        // ContainerView metatable: __index, __newindex, __len, __pairs, __ipairs and methods
+        // the view is the first argument of every function
+        template<typename C>
+        class ContainerViewMetatable {
+        public:
+            // stack argument: metatable
+            static void setFunctions(lua_State *luaState);
+
+        private:
+            using Traits = ContainerViewTraits<C>;
+            using ValueType = typename Traits::ValueType;
+
+            inline static C & getContainer(lua_State *luaState);
+
+            // stack: view | key
+            // looks up a method in the metatable (names that are not elements)
+            static int pushMethod(lua_State *luaState);
+
+            // stack: ? | key
+            // returns false if key is not a valid sequence index (it does not throw)
+            static bool getSequenceIndex(lua_State *luaState, std::size_t size, std::size_t *sequenceIndex);
+
+            static int index(lua_State *luaState);
+            static int newIndex(lua_State *luaState);
+            static int getLength(lua_State *luaState);
+            static int next(lua_State *luaState);
+            static int pairs(lua_State *luaState);
+            // std::vector only
+            static int pushBack(lua_State *luaState);
+            // std::vector (index) and std::unordered_map (key)
+            static int erase(lua_State *luaState);
+
+            // exceptions are translated to lua errors
+            template<int (*F)(lua_State *)>
+            static int callFunction(lua_State *luaState);
+        };
+
+        namespace exchanger {
+            template<typename C>
+            class Exchanger<ContainerView<C>> : public AutomaticInheritanceBase<ContainerView<C>> {
+            public:
+                inline static void push(lua_State *luaState, const ContainerView<C> &containerView);
+            };
+        }
+    }
+
+    //--
+
+    template<typename C>
+    inline ContainerView<C>::ContainerView(C &container) :
+        // aliasing constructor with an empty owner: no ownership and no allocation
+        container_(std::shared_ptr<C>(), &container)
+    {}
+
+    template<typename C>
+    inline ContainerView<C>::ContainerView(std::shared_ptr<C> container) : container_(std::move(container)) {}
+
+    template<typename C>
+    inline C & ContainerView<C>::get() const {
+        return *container_;
+    }
+
+    namespace detail {
+        template<typename C>
+        void ContainerViewMetatable<C>::setFunctions(lua_State *luaState) {
+            // stack: metatable
+            basic::setLuaFunction(luaState, "__index", &callFunction<&index>, 0);
+            basic::setLuaFunction(luaState, "__newindex", &callFunction<&newIndex>, 0);
+            basic::setLuaFunction(luaState, "__len", &callFunction<&getLength>, 0);
+            basic::setLuaFunction(luaState, "__pairs", &callFunction<&pairs>, 0);
+            if constexpr (Traits::keIsSequence == true) {
+                // lua 5.2 (lua 5.3 ipairs uses __index)
+                basic::setLuaFunction(luaState, "__ipairs", &callFunction<&pairs>, 0);
+            }
+            if constexpr (Traits::keIsResizable == true) {
+                basic::setLuaFunction(luaState, "push_back", &callFunction<&pushBack>, 0);
+            }
+            if constexpr (Traits::keIsResizable == true || Traits::keIsSequence == false) {
+                basic::setLuaFunction(luaState, "erase", &callFunction<&erase>, 0);
+            }
+            // stack: metatable
+        }
+
+        template<typename C>
+        inline C & ContainerViewMetatable<C>::getContainer(lua_State *luaState) {
+            return exchanger::get<ContainerView<C>>(luaState, 1).get();
+        }
+
+        template<typename C>
+        int ContainerViewMetatable<C>::pushMethod(lua_State *luaState) {
+            // stack: view | key
+            if (lua_getmetatable(luaState, 1) == 0) {
+                lua_pushnil(luaState);
+                return 1;
+            }
+            // stack: view | key | metatable
+            lua_pushvalue(luaState, 2);
+            // stack: view | key | metatable | key
+            // lua_gettable: methods of the inherited container class are looked up too
+            lua_gettable(luaState, -2);
+            // stack: view | key | metatable | method (?)
+            return 1;
+        }
+
+        template<typename C>
+        bool ContainerViewMetatable<C>::getSequenceIndex(lua_State *luaState, std::size_t size, std::size_t *sequenceIndex) {
+            if (lua_type(luaState, 2) == LUA_TNUMBER) {
+                int isInteger;
+                const lua_Integer integer = lua_compatibility::tointegerx(luaState, 2, &isInteger);
+                if (isInteger != 0 && integer >= 1 && static_cast<std::size_t>(integer) <= size) {
+                    *sequenceIndex = static_cast<std::size_t>(integer) - 1;
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        template<typename C>
+        int ContainerViewMetatable<C>::index(lua_State *luaState) {
+            // stack: view | key
+            C &container = getContainer(luaState);
+            if constexpr (Traits::keIsSequence == true) {
+                if (lua_type(luaState, 2) != LUA_TSTRING) {
+                    std::size_t sequenceIndex;
+                    if (getSequenceIndex(luaState, container.size(), &sequenceIndex) == true) {
+                        exchanger::push<ValueType>(luaState, container[sequenceIndex]);
+                    } else {
+                        lua_pushnil(luaState);
+                    }
+                    return 1;
+                }
+            } else {
+                using KeyType = typename Traits::KeyType;
+                using KeyArgument = OverloadArgument<std::decay_t<KeyType>>;
+                // the key is converted only if its lua type matches
+                if ((getLuaTypeMask(lua_type(luaState, 2)) & KeyArgument::keLuaTypeMask) != 0 && KeyArgument::isObject(luaState, 2) == true) {
+                    const auto iterator = container.find(exchanger::get<KeyType>(luaState, 2));
+                    if (iterator != container.end()) {
+                        exchanger::push<ValueType>(luaState, iterator->second);
+                        return 1;
+                    }
+                }
+            }
+            return pushMethod(luaState);
+        }
+
+        template<typename C>
+        int ContainerViewMetatable<C>::newIndex(lua_State *luaState) {
+            // stack: view | key | value
+            C &container = getContainer(luaState);
+            if constexpr (Traits::keIsSequence == true) {
+                std::size_t sequenceIndex;
+                if (getSequenceIndex(luaState, container.size(), &sequenceIndex) == true) {
+                    container[sequenceIndex] = exchanger::get<ValueType>(luaState, 3);
+                    return 0;
+                }
+                if constexpr (Traits::keIsResizable == true) {
+                    if (getSequenceIndex(luaState, container.size() + 1, &sequenceIndex) == true) {
+                        container.push_back(exchanger::get<ValueType>(luaState, 3));
+                        return 0;
+                    }
+                }
+                throw ArgumentException(luaState, 2, "container index out of range");
+            } else {
+                if (lua_isnil(luaState, 3) != 0) {
+                    container.erase(exchanger::get<typename Traits::KeyType>(luaState, 2));
+                } else {
+                    container.insert_or_assign(exchanger::get<typename Traits::KeyType>(luaState, 2), exchanger::get<ValueType>(luaState, 3));
+                }
+                return 0;
+            }
+        }
+
+        template<typename C>
+        int ContainerViewMetatable<C>::getLength(lua_State *luaState) {
+            lua_compatibility::pushunsigned(luaState, getContainer(luaState).size());
+            return 1;
+        }
+
+        template<typename C>
+        int ContainerViewMetatable<C>::next(lua_State *luaState) {
+            // stack: view | key
+            C &container = getContainer(luaState);
+            if constexpr (Traits::keIsSequence == true) {
+                const std::size_t nextIndex = (lua_isnil(luaState, 2) != 0) ? 0 : static_cast<std::size_t>(exchanger::get<lua_Integer>(luaState, 2));
+                if (nextIndex < container.size()) {
+                    lua_compatibility::pushunsigned(luaState, nextIndex + 1);
+                    exchanger::push<ValueType>(luaState, container[nextIndex]);
+                    return 2;
+                }
+            } else {
+                using KeyType = typename Traits::KeyType;
+                auto iterator = container.begin();
+                if (lua_isnil(luaState, 2) == 0) {
+                    iterator = container.find(exchanger::get<KeyType>(luaState, 2));
+                    if (iterator != container.end()) {
+                        ++iterator;
+                    }
+                }
+                if (iterator != container.end()) {
+                    exchanger::push<KeyType>(luaState, iterator->first);
+                    exchanger::push<ValueType>(luaState, iterator->second);
+                    return 2;
+                }
+            }
+            lua_pushnil(luaState);
+            return 1;
+        }
+
+        template<typename C>
+        int ContainerViewMetatable<C>::pairs(lua_State *luaState) {
+            // stack: view
+            lua_pushcclosure(luaState, &callFunction<&next>, 0);
+            lua_pushvalue(luaState, 1);
+            lua_pushnil(luaState);
+            // stack: view | next | view | nil
+            return 3;
+        }
+
+        template<typename C>
+        int ContainerViewMetatable<C>::pushBack(lua_State *luaState) {
+            // stack: view | value
+            getContainer(luaState).push_back(exchanger::get<ValueType>(luaState, 2));
+            return 0;
+        }
+
+        template<typename C>
+        int ContainerViewMetatable<C>::erase(lua_State *luaState) {
+            // stack: view | key
+            C &container = getContainer(luaState);
+            if constexpr (Traits::keIsSequence == true) {
+                std::size_t sequenceIndex;
+                if (getSequenceIndex(luaState, container.size(), &sequenceIndex) == true) {
+                    container.erase(container.begin() + static_cast<typename C::difference_type>(sequenceIndex));
+                    return 0;
+                }
+                throw ArgumentException(luaState, 2, "container index out of range");
+            } else {
+                container.erase(exchanger::get<typename Traits::KeyType>(luaState, 2));
+                return 0;
+            }
+        }
+
+        template<typename C>
+        template<int (*F)(lua_State *)>
+        int ContainerViewMetatable<C>::callFunction(lua_State *luaState) {
+            return exchanger::callLuaFunction(luaState, F);
+        }
+
+        namespace exchanger {
+            template<typename C>
+            inline void Exchanger<ContainerView<C>>::push(lua_State *luaState, const ContainerView<C> &containerView) {
+                AutomaticInheritanceBase<ContainerView<C>>::pushGeneric(
+                    luaState,
+                    [](lua_State *lambdaLuaState) {
+                        // stack: metatable
+                        type_manager::setInheritance(lambdaLuaState, [](ContainerView<C> *containerViewPointer) -> C * {
+                            return &containerViewPointer->get();
+                        });
+                        ContainerViewMetatable<C>::setFunctions(lambdaLuaState);
+                    },
+                    containerView
+                );
+            }
+        }
+    }
+}
+
+#endif
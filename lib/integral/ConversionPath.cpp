@@ -0,0 +1,60 @@
+//
+//  ConversionPath.cpp
+//  integral
+//
+// MIT License
+//
+// Copyright (c) 2024 André Pereira Henriques (aphenriques (at) outlook (dot) com)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include "ConversionPath.hpp"
+#include <cstddef>
+#include <vector>
+#include "TypeFunction.hpp"
+
+namespace integral {
+    namespace detail {
+        void * ConversionPath::convert(void *userData) const {
+            void * const underlyingObject = underlyingTypeFunction_(userData);
+            if (isOffsetComposed_ == true) {
+                return static_cast<char *>(underlyingObject) + composedOffset_;
+            }
+            void *object = underlyingObject;
+            for (const TypeFunction *typeFunction : typeFunctions_) {
+                object = (*typeFunction)(object);
+            }
+            if (isConstantOffset_ == true) {
+                composedOffset_ = static_cast<char *>(object) - static_cast<char *>(underlyingObject);
+                isOffsetComposed_ = true;
+            }
+            return object;
+        }
+
+        bool ConversionPath::checkConstantOffset(const std::vector<const TypeFunction *> &typeFunctions) {
+            for (const TypeFunction *typeFunction : typeFunctions) {
+                if (typeFunction->isConstantOffset_ == false) {
+                    return false;
+                }
+            }
+            return true;
+        }
+    }
+}
@@ -0,0 +1,86 @@
+//
+//  ConversionPath.hpp
+//  integral
+//
+// MIT License
+//
+// Copyright (c) 2024 André Pereira Henriques (aphenriques (at) outlook (dot) com)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#ifndef integral_ConversionPath_hpp
+#define integral_ConversionPath_hpp
+
+#include <cstddef>
+#include <vector>
+#include "TypeFunction.hpp"
+
+namespace integral {
+    namespace detail {
+        // Resolved type conversion (userdata -> underlying type -> ... -> converted type) as a sequence of native type functions
+        // It is stored in the type_manager conversion path cache. TypeFunctions are owned by type function closures from metatables, which outlive the cache.
+        class ConversionPath {
+        public:
+            inline ConversionPath(const TypeFunction &underlyingTypeFunction, std::vector<const TypeFunction *> &&typeFunctions);
+
+            // conversion with a known constant offset (relative to the underlying type pointer). E.g.: memoized dynamic_cast
+            inline ConversionPath(const TypeFunction &underlyingTypeFunction, std::ptrdiff_t offset);
+
+            // non-copyable
+            ConversionPath(const ConversionPath &) = delete;
+            ConversionPath & operator=(const ConversionPath &) = delete;
+
+            inline bool isConstantOffset() const;
+
+            // userData: lua_touserdata of a userdata with the (source) metatable of the conversion path
+            void * convert(void *userData) const;
+
+        private:
+            const TypeFunction &underlyingTypeFunction_;
+            const std::vector<const TypeFunction *> typeFunctions_;
+            const bool isConstantOffset_;
+            // constant offset type functions are composed into a single offset (relative to the underlying type pointer) in the first conversion
+            mutable bool isOffsetComposed_ = false;
+            mutable std::ptrdiff_t composedOffset_ = 0;
+
+            static bool checkConstantOffset(const std::vector<const TypeFunction *> &typeFunctions);
+        };
+
+        //--
+
+        inline ConversionPath::ConversionPath(const TypeFunction &underlyingTypeFunction, std::vector<const TypeFunction *> &&typeFunctions) :
+            underlyingTypeFunction_(underlyingTypeFunction),
+            typeFunctions_(std::move(typeFunctions)),
+            isConstantOffset_(checkConstantOffset(typeFunctions_)) {}
+
+        inline ConversionPath::ConversionPath(const TypeFunction &underlyingTypeFunction, std::ptrdiff_t offset) :
+            underlyingTypeFunction_(underlyingTypeFunction),
+            typeFunctions_(),
+            isConstantOffset_(true),
+            isOffsetComposed_(true),
+            composedOffset_(offset) {}
+
+        inline bool ConversionPath::isConstantOffset() const {
+            return isConstantOffset_;
+        }
+    }
+}
+
+#endif
@@ -29,30 +29,51 @@
 
 #include <cstddef>
 #include <tuple>
+#include <type_traits>
 #include <utility>
 #include <lua.hpp>
 #include "DefaultArgument.hpp"
 #include "exchanger.hpp"
 #include "generic.hpp"
+#include "LuaFunctionWrapper.hpp"
 
 namespace integral {
     namespace detail {
+        // Default arguments are converted to lua values once (pushDefaultArguments) and stored as upvalues of the bound function (LuaFunctionWrapper::getUpValueIndex(1)...).
+        // Missing arguments are copied from the upvalues with lua_pushvalue. Arguments taken by non-const lvalue reference are pushed (converted) on every call instead, so that changes made by the function do not persist.
+        // "typename ...A" (member function templates): bound function argument types
         template<typename ...F>
         class DefaultArgumentManager {
         public:
             template<typename ...E, std::size_t ...I>
             inline DefaultArgumentManager(DefaultArgument<E, I> &&...defaultArguments);
 
+            // pushes one upvalue per default argument (nil for arguments that are not shared)
+            // returns the number of pushed values
+            template<typename ...A>
+            int pushDefaultArguments(lua_State *luaState) const;
+
+            template<typename ...A>
             void processDefaultArguments(lua_State *luaState, const std::size_t numberOfFunctionArguments, const std::size_t numberOfArgumentsOnStack) const;
 
         private:            
             std::tuple<F...> defaultArguments_;
 
-            template<std::size_t ...S>
+            // whether a default argument of type A is stored as an upvalue and shared by every call
+            template<typename A>
+            static constexpr bool keIsShared = std::is_lvalue_reference_v<A> == false || std::is_const_v<std::remove_reference_t<A>> == true;
+
+            template<typename ...A, std::size_t ...S>
+            inline void pushDefaultArguments(lua_State *luaState, std::index_sequence<S...>) const;
+
+            template<typename ...A, std::size_t ...S>
             inline void processDefaultArguments(lua_State *luaState, std::index_sequence<S...>) const;
 
-            template<typename E, std::size_t I>
-            void processArgument(lua_State *luaState, const DefaultArgument<E, I> &defaultArgument) const;
+            template<typename ...A, typename E, std::size_t I>
+            void pushArgument(lua_State *luaState, const DefaultArgument<E, I> &defaultArgument) const;
+
+            template<typename ...A, typename E, std::size_t I>
+            void processArgument(lua_State *luaState, const DefaultArgument<E, I> &defaultArgument, int upValueIndex) const;
         };
 
         //--
@@ -62,6 +83,14 @@ namespace integral {
         inline DefaultArgumentManager<F...>::DefaultArgumentManager(DefaultArgument<E, I> &&...defaultArguments) : defaultArguments_(std::move(defaultArguments)...) {}
 
         template<typename ...F>
+        template<typename ...A>
+        int DefaultArgumentManager<F...>::pushDefaultArguments(lua_State *luaState) const {
+            pushDefaultArguments<A...>(luaState, std::index_sequence_for<F...>());
+            return static_cast<int>(sizeof...(F));
+        }
+
+        template<typename ...F>
+        template<typename ...A>
         void DefaultArgumentManager<F...>::processDefaultArguments(lua_State *luaState, const std::size_t numberOfFunctionArguments, const std::size_t numberOfArgumentsOnStack) const {
             if (numberOfArgumentsOnStack < numberOfFunctionArguments) {
                 const std::size_t numberOfArgumentsDifference = numberOfFunctionArguments - numberOfArgumentsOnStack;
@@ -69,23 +98,45 @@ namespace integral {
                     lua_pushnil(luaState);
                 }
             }
-            processDefaultArguments(luaState, std::index_sequence_for<F...>());
+            processDefaultArguments<A...>(luaState, std::index_sequence_for<F...>());
         }
 
         template<typename ...F>
-        template<std::size_t ...S>
+        template<typename ...A, std::size_t ...S>
+        // [[maybe_unused]]: see processDefaultArguments
+        inline void DefaultArgumentManager<F...>::pushDefaultArguments([[maybe_unused]] lua_State *luaState, std::index_sequence<S...>) const {
+            // comma fold: left to right evaluation (upvalue S + 1 is default argument S). The evaluation order of function arguments (expandDummyTemplatePack) is unspecified
+            (pushArgument<A...>(luaState, std::get<S>(defaultArguments_)), ...);
+        }
+
+        template<typename ...F>
+        template<typename ...A, std::size_t ...S>
         // [[maybe_unused]] is used because of a bug in gcc 7.4 which incorrectly shows the following warning:
         // error: parameter ‘luaState’ set but not used [-Werror=unused-but-set-parameter]
         // FIXME remove [[maybe_unused]] in future versions
         inline void DefaultArgumentManager<F...>::processDefaultArguments([[maybe_unused]] lua_State *luaState, std::index_sequence<S...>) const {
-            generic::expandDummyTemplatePack((processArgument(luaState, std::get<S>(defaultArguments_)), 0)...);
+            generic::expandDummyTemplatePack((processArgument<A...>(luaState, std::get<S>(defaultArguments_), LuaFunctionWrapper::getUpValueIndex(static_cast<int>(S) + 1)), 0)...);
         }
 
         template<typename ...F>
-        template<typename E, std::size_t I>
-        void DefaultArgumentManager<F...>::processArgument(lua_State *luaState, const DefaultArgument<E, I> &defaultArgument) const {
-            if (lua_isnil(luaState, I) != 0) {
+        template<typename ...A, typename E, std::size_t I>
+        void DefaultArgumentManager<F...>::pushArgument(lua_State *luaState, const DefaultArgument<E, I> &defaultArgument) const {
+            if constexpr (keIsShared<std::tuple_element_t<I - 1, std::tuple<A...>>> == true) {
                 exchanger::push<E>(luaState, defaultArgument.getArgument());
+            } else {
+                lua_pushnil(luaState);
+            }
+        }
+
+        template<typename ...F>
+        template<typename ...A, typename E, std::size_t I>
+        void DefaultArgumentManager<F...>::processArgument(lua_State *luaState, const DefaultArgument<E, I> &defaultArgument, [[maybe_unused]] int upValueIndex) const {
+            if (lua_isnil(luaState, I) != 0) {
+                if constexpr (keIsShared<std::tuple_element_t<I - 1, std::tuple<A...>>> == true) {
+                    lua_pushvalue(luaState, upValueIndex);
+                } else {
+                    exchanger::push<E>(luaState, defaultArgument.getArgument());
+                }
                 lua_replace(luaState, I);
             }
         }
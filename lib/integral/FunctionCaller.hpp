@@ -54,8 +54,7 @@ namespace integral {
         template<typename R, typename ...A>
         template<std::size_t ...S>
         int FunctionCaller<R, A...>::call(lua_State *luaState, const std::function<R(A...)> &function, std::index_sequence<S...>) {
-            exchanger::push<R>(luaState, function(exchanger::get<A>(luaState, S + 1)...));
-            return 1;
+            return exchanger::pushReturnValue<R>(luaState, function(exchanger::get<A>(luaState, S + 1)...));
         }
 
         template<typename ...A>
@@ -109,17 +109,19 @@ namespace integral {
             template<typename R, typename ...A, typename M>
             template<typename W>
             void Exchanger<FunctionWrapper<R(A...), M>>::genericPush(lua_State *luaState, W &&functionWrapper) {
+                // default arguments are stored as upvalues (see DefaultArgumentManager)
+                const int numberOfDefaultArguments = functionWrapper.getDefaultArgumentManager().template pushDefaultArguments<A...>(luaState);
                 exchanger::push<LuaFunctionWrapper>(luaState, [lambdaFunctionWrapper = std::forward<W>(functionWrapper)](lua_State *lambdaLuaState) -> int {
                     // replicate code of maximum number of parameters checking in Exchanger<ConstructorWrapper<T(A...), M>>::push
                     const std::size_t numberOfArgumentsOnStack = static_cast<std::size_t>(lua_gettop(lambdaLuaState));
                     constexpr std::size_t keCppNumberOfArguments = sizeof...(A);
                     if (numberOfArgumentsOnStack <= keCppNumberOfArguments) {
-                         lambdaFunctionWrapper.getDefaultArgumentManager().processDefaultArguments(lambdaLuaState, keCppNumberOfArguments, numberOfArgumentsOnStack);
+                         lambdaFunctionWrapper.getDefaultArgumentManager().template processDefaultArguments<A...>(lambdaLuaState, keCppNumberOfArguments, numberOfArgumentsOnStack);
                         return FunctionCaller<R, A...>::call(lambdaLuaState, lambdaFunctionWrapper.getFunction(), std::make_index_sequence<keCppNumberOfArguments>());
                     } else {
                         throw ArgumentException(lambdaLuaState, keCppNumberOfArguments, numberOfArgumentsOnStack);
                     }
-                });
+                }, numberOfDefaultArguments);
             }
         }
     }
@@ -0,0 +1,106 @@
+//
+//  InlineCache.cpp
+//  integral
+//
+// MIT License
+//
+// Copyright (c) 2024 André Pereira Henriques (aphenriques (at) outlook (dot) com)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "InlineCache.hpp"
+#include <atomic>
+#include <cstddef>
+#include <lua.hpp>
+#include "basic.hpp"
+#include "lua_compatibility.hpp"
+#include "type_manager.hpp"
+#include "TypeKey.hpp"
+
+namespace integral {
+    namespace detail {
+        // starts at 1: default constructed entries (epoch_ = 0) are never valid
+        std::atomic<unsigned long> InlineCache::epoch_(1);
+
+        void InlineCache::insert(lua_State *luaState, int index, const void *object) {
+            void * const userData = lua_touserdata(luaState, index);
+            if (userData != nullptr && lua_getmetatable(luaState, index) != 0) {
+                // stack: metatable
+                lua_pushstring(luaState, type_manager::gkUserDataWrapperAlignmentKey);
+                // stack: metatable | gkUserDataWrapperAlignmentKey
+                lua_rawget(luaState, -2);
+                // stack: metatable | alignment (?)
+                int isNumber;
+                const lua_Integer alignment = lua_compatibility::tointegerx(luaState, -1, &isNumber);
+                if (isNumber != 0 && alignment > 0) {
+                    // stack: metatable | alignment
+                    const void * const metatable = lua_topointer(luaState, -2);
+                    lua_pop(luaState, 2);
+                    // stack:
+                    registerStateSentinel(luaState);
+                    Entry &entry = entries_[nextEntryIndex_];
+                    nextEntryIndex_ = (nextEntryIndex_ + 1) % keSize_;
+                    entry.metatable_ = metatable;
+                    entry.alignment_ = static_cast<std::size_t>(alignment);
+                    entry.offset_ = static_cast<const char *>(object) - static_cast<const char *>(basic::getAlignedOffsetPointer(userData, entry.alignment_));
+                    // the epoch is read after the sentinel registration
+                    entry.epoch_ = epoch_.load(std::memory_order_acquire);
+                } else {
+                    // stack: metatable | ?
+                    lua_pop(luaState, 2);
+                    // stack:
+                }
+            }
+        }
+
+        void InlineCache::invalidate() {
+            epoch_.fetch_add(1, std::memory_order_release);
+        }
+
+        // lua_CFunction style function: no exceptions and no objects (with destructors)
+        int InlineCache::callStateSentinelGcMetamethod(lua_State *) {
+            invalidate();
+            return 0;
+        }
+
+        void InlineCache::registerStateSentinel(lua_State *luaState) {
+            lua_compatibility::rawgetp(luaState, LUA_REGISTRYINDEX, TypeKey<InlineCache>::get());
+            // stack: sentinel (?)
+            if (lua_isuserdata(luaState, -1) == 0) {
+                // stack: nil (?)
+                lua_pop(luaState, 1);
+                // stack:
+                lua_compatibility::newuserdata(luaState, 1);
+                // stack: sentinel*
+                lua_createtable(luaState, 0, 1);
+                // stack: sentinel* | sentinelMetatable*
+                basic::setLuaFunction(luaState, "__gc", &callStateSentinelGcMetamethod, 0);
+                // stack: sentinel* | sentinelMetatable*
+                lua_setmetatable(luaState, -2);
+                // stack: sentinel*
+                lua_compatibility::rawsetp(luaState, LUA_REGISTRYINDEX, TypeKey<InlineCache>::get());
+                // stack:
+            } else {
+                // stack: sentinel
+                lua_pop(luaState, 1);
+                // stack:
+            }
+        }
+    }
+}
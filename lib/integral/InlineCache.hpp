@@ -0,0 +1,91 @@
+//
+//  InlineCache.hpp
+//  integral
+//
+// MIT License
+//
+// Copyright (c) 2024 André Pereira Henriques (aphenriques (at) outlook (dot) com)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef integral_InlineCache_hpp
+#define integral_InlineCache_hpp
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <lua.hpp>
+#include "basic.hpp"
+
+namespace integral {
+    namespace detail {
+        // Call site cache of userdata to object pointer conversions (e.g.: one thread_local instance per exchanger::getObject<T> instantiation)
+        // Each entry maps an integral root metatable address to a constant pointer adjustment:
+        //   object = getAlignedOffsetPointer(userData, alignment) + offset
+        // Root metatables are only collected when their lua_State is closed. Closing a lua_State that filled an entry invalidates every InlineCache (global epoch), so a reused metatable address never hits a stale entry.
+        // Changing the type conversion graph (type_manager::setTypeFunction and setInheritanceTable) also invalidates every InlineCache.
+        class InlineCache {
+        public:
+            // returns nullptr if there is no entry for metatable
+            inline void * find(void *userData, const void *metatable) const;
+
+            // index: integral userdata (the root metatable must have type_manager::gkUserDataWrapperAlignmentKey; otherwise, nothing is cached)
+            // object: conversion of the userdata which must be a constant offset for every userdata with the same metatable
+            void insert(lua_State *luaState, int index, const void *object);
+
+            // invalidates every InlineCache entry (e.g.: type conversion graph change)
+            static void invalidate();
+
+        private:
+            class Entry {
+            public:
+                const void *metatable_ = nullptr;
+                std::size_t alignment_ = 1;
+                std::ptrdiff_t offset_ = 0;
+                unsigned long epoch_ = 0;
+            };
+
+            static constexpr std::size_t keSize_ = 4;
+
+            static std::atomic<unsigned long> epoch_;
+
+            std::array<Entry, keSize_> entries_;
+            std::size_t nextEntryIndex_ = 0;
+
+            static int callStateSentinelGcMetamethod(lua_State *luaState);
+
+            // sets REGISTRY[TypeKey<InlineCache>::get()] = sentinel userdata whose __gc (called by lua_close) increments epoch_
+            static void registerStateSentinel(lua_State *luaState);
+        };
+
+        //--
+
+        inline void * InlineCache::find(void *userData, const void *metatable) const {
+            const unsigned long epoch = epoch_.load(std::memory_order_acquire);
+            for (const Entry &entry : entries_) {
+                if (entry.metatable_ == metatable && entry.epoch_ == epoch) {
+                    return static_cast<char *>(basic::getAlignedOffsetPointer(userData, entry.alignment_)) + entry.offset_;
+                }
+            }
+            return nullptr;
+        }
+    }
+}
+
+#endif
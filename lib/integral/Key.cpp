@@ -0,0 +1,95 @@
+//
+//  Key.cpp
+//  integral
+//
+// MIT License
+//
+// Copyright (c) 2024 André Pereira Henriques (aphenriques (at) outlook (dot) com)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include "Key.hpp"
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <lua.hpp>
+#include "lua_compatibility.hpp"
+#include "serializer.hpp"
+#include "TypeKey.hpp"
+
+namespace integral::detail {
+    Key::Key(lua_State *luaState, std::string_view name) : luaState_(lua_compatibility::getmainthread(luaState)) {
+        lua_compatibility::rawgetp(luaState, LUA_REGISTRYINDEX, TypeKey<Key>::get());
+        // stack: keys (?)
+        if (lua_istable(luaState, -1) == 0) {
+            // stack: nil
+            lua_pop(luaState, 1);
+            // stack:
+            lua_newtable(luaState);
+            // stack: keys*
+            lua_pushvalue(luaState, -1);
+            // stack: keys* | keys*
+            lua_compatibility::rawsetp(luaState, LUA_REGISTRYINDEX, TypeKey<Key>::get());
+        }
+        // stack: keys
+        lua_pushlstring(luaState, name.data(), name.size());
+        // stack: keys | name
+        lua_pushvalue(luaState, -1);
+        // stack: keys | name | name
+        lua_rawget(luaState, -3);
+        // stack: keys | name | slot (?)
+        if (lua_isnumber(luaState, -1) != 0) {
+            reference_ = static_cast<int>(lua_tointeger(luaState, -1));
+            lua_pop(luaState, 3);
+            // stack:
+        } else {
+            // stack: keys | name | nil
+            lua_pop(luaState, 1);
+            // stack: keys | name
+            lua_pushvalue(luaState, -1);
+            // stack: keys | name | name
+            reference_ = luaL_ref(luaState, LUA_REGISTRYINDEX);
+            // stack: keys | name
+            lua_pushinteger(luaState, static_cast<lua_Integer>(reference_));
+            // stack: keys | name | slot
+            lua_rawset(luaState, -3);
+            // stack: keys
+            lua_pop(luaState, 1);
+            // stack:
+        }
+    }
+
+    std::string Key::getName() const {
+        push(luaState_);
+        // stack: name
+        std::size_t length;
+        const char * const name = lua_tolstring(luaState_, -1, &length);
+        std::string returnValue(name, length);
+        lua_pop(luaState_, 1);
+        // stack:
+        return returnValue;
+    }
+
+    namespace serializer {
+        std::string Serializer<Key>::getString(const Key &key) {
+            return Serializer<std::string>::getString(key.getName());
+        }
+    }
+}
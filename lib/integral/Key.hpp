@@ -0,0 +1,91 @@
+//
+//  Key.hpp
+//  integral
+//
+// MIT License
+//
+// Copyright (c) 2024 André Pereira Henriques (aphenriques (at) outlook (dot) com)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#ifndef integral_Key_hpp
+#define integral_Key_hpp
+
+#include <string>
+#include <string_view>
+#include <lua.hpp>
+#include "exchanger.hpp"
+#include "serializer.hpp"
+
+namespace integral::detail {
+    // lua string interned once and kept in a lua registry slot (luaL_ref): it is pushed with a single lua_rawgeti (no string hashing)
+    // slots are interned by name: REGISTRY[TypeKey<Key>::get()] = {[name] = slot}. Keys constructed with the same name share a slot, so the registry grows only with the number of distinct names (slots are released when the lua state is closed)
+    // copies share the slot (trivially copyable)
+    // it keeps the main thread (see LuaFunctionBase)
+    class Key {
+    public:
+        Key(lua_State *luaState, std::string_view name);
+
+        inline lua_State * getLuaState() const;
+
+        // "luaState": any thread of the key lua_State (the registry is shared)
+        inline void push(lua_State *luaState) const;
+
+        std::string getName() const;
+
+    private:
+        lua_State *luaState_;
+        int reference_;
+    };
+
+    namespace exchanger {
+        template<>
+        class Exchanger<Key> {
+        public:
+            inline static void push(lua_State *luaState, const Key &key);
+        };
+    }
+
+    namespace serializer {
+        template<>
+        class Serializer<Key> {
+        public:
+            static std::string getString(const Key &key);
+        };
+    }
+
+    //--
+
+    inline lua_State * Key::getLuaState() const {
+        return luaState_;
+    }
+
+    inline void Key::push(lua_State *luaState) const {
+        lua_rawgeti(luaState, LUA_REGISTRYINDEX, reference_);
+    }
+
+    namespace exchanger {
+        inline void Exchanger<Key>::push(lua_State *luaState, const Key &key) {
+            key.push(luaState);
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,56 @@
+//
+//  LuaError.hpp
+//  integral
+//
+// MIT License
+//
+// Copyright (c) 2024 André Pereira Henriques (aphenriques (at) outlook (dot) com)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#ifndef integral_LuaError_hpp
+#define integral_LuaError_hpp
+
+namespace integral {
+    namespace detail {
+        // thrown by Caller::callUnprotected on lua error: the error value is kept in the lua stack (no message copy) and exchanger::callLuaFunction raises it again unchanged (lua_error) after the C++ frames are unwound
+        // it is not derived from std::exception: it must not be handled by the bound function
+        class LuaError {
+        public:
+            // "errorIndex": absolute stack index of the error value
+            inline explicit LuaError(int errorIndex);
+
+            inline int getErrorIndex() const;
+
+        private:
+            int errorIndex_;
+        };
+
+        //--
+
+        inline LuaError::LuaError(int errorIndex) : errorIndex_(errorIndex) {}
+
+        inline int LuaError::getErrorIndex() const {
+            return errorIndex_;
+        }
+    }
+}
+
+#endif
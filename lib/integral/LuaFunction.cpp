@@ -0,0 +1,88 @@
+//
+//  LuaFunction.cpp
+//  integral
+//
+// MIT License
+//
+// Copyright (c) 2024 André Pereira Henriques (aphenriques (at) outlook (dot) com)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include "LuaFunction.hpp"
+#include <lua.hpp>
+#include "ArgumentException.hpp"
+#include "lua_compatibility.hpp"
+
+namespace integral {
+    namespace detail {
+        LuaFunctionBase::LuaFunctionBase(const LuaFunctionBase &luaFunctionBase) : luaState_(luaFunctionBase.luaState_) {
+            luaFunctionBase.push(luaState_);
+            // stack: function
+            reference_ = luaL_ref(luaState_, LUA_REGISTRYINDEX);
+            // stack:
+        }
+
+        LuaFunctionBase & LuaFunctionBase::operator=(const LuaFunctionBase &luaFunctionBase) {
+            if (this != &luaFunctionBase) {
+                luaL_unref(luaState_, LUA_REGISTRYINDEX, reference_);
+                luaState_ = luaFunctionBase.luaState_;
+                luaFunctionBase.push(luaState_);
+                // stack: function
+                reference_ = luaL_ref(luaState_, LUA_REGISTRYINDEX);
+                // stack:
+            }
+            return *this;
+        }
+
+        LuaFunctionBase::LuaFunctionBase(LuaFunctionBase &&luaFunctionBase) : luaState_(luaFunctionBase.luaState_), reference_(luaFunctionBase.reference_) {
+            luaFunctionBase.reference_ = LUA_NOREF;
+        }
+
+        LuaFunctionBase & LuaFunctionBase::operator=(LuaFunctionBase &&luaFunctionBase) {
+            if (this != &luaFunctionBase) {
+                luaL_unref(luaState_, LUA_REGISTRYINDEX, reference_);
+                luaState_ = luaFunctionBase.luaState_;
+                reference_ = luaFunctionBase.reference_;
+                luaFunctionBase.reference_ = LUA_NOREF;
+            }
+            return *this;
+        }
+
+        LuaFunctionBase::LuaFunctionBase(lua_State *luaState, int index) : luaState_(lua_compatibility::getmainthread(luaState)) {
+            // element at index stack position might not be a function and have a valid __call metamethod
+            if (lua_isfunction(luaState, index) == 0) {
+                if (luaL_getmetafield(luaState, index, "__call") == 0) {
+                    throw ArgumentException::createTypeErrorException(luaState, index, "function");
+                }
+                // stack: __call
+                lua_pop(luaState, 1);
+            }
+            lua_pushvalue(luaState, index);
+            // stack: function
+            reference_ = luaL_ref(luaState, LUA_REGISTRYINDEX);
+            // stack:
+        }
+
+        LuaFunctionBase::~LuaFunctionBase() {
+            // luaL_unref ignores LUA_NOREF (moved function)
+            luaL_unref(luaState_, LUA_REGISTRYINDEX, reference_);
+        }
+    }
+}
@@ -0,0 +1,120 @@
+//
+//  LuaFunction.hpp
+//  integral
+//
+// MIT License
+//
+// Copyright (c) 2024 André Pereira Henriques (aphenriques (at) outlook (dot) com)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#ifndef integral_LuaFunction_hpp
+#define integral_LuaFunction_hpp
+
+#include <utility>
+#include <lua.hpp>
+#include "Caller.hpp"
+#include "exchanger.hpp"
+
+namespace integral {
+    namespace detail {
+        // (either C++ or lua) function kept in a lua registry slot (luaL_ref) until destruction
+        // copies take their own registry slot
+        // a LuaFunctionBase must not outlive its lua_State
+        // it keeps the main thread (the thread it is gotten from might be a coroutine that is collected before the function is called)
+        class LuaFunctionBase {
+        public:
+            LuaFunctionBase(const LuaFunctionBase &luaFunctionBase);
+            LuaFunctionBase & operator=(const LuaFunctionBase &luaFunctionBase);
+
+            LuaFunctionBase(LuaFunctionBase &&luaFunctionBase);
+            LuaFunctionBase & operator=(LuaFunctionBase &&luaFunctionBase);
+
+            // throws ArgumentException if the element at index is neither a function nor has a __call metamethod
+            LuaFunctionBase(lua_State *luaState, int index);
+
+            ~LuaFunctionBase();
+
+            inline lua_State * getLuaState() const;
+            // "luaState": any thread of the function lua_State (the registry is shared)
+            inline void push(lua_State *luaState) const;
+
+        private:
+            lua_State *luaState_;
+            int reference_;
+        };
+
+        template<typename F>
+        class LuaFunction;
+
+        // std::function compatible: LuaFunction<R(A...)> can be stored in a std::function<R(A...)>
+        // "R" is a non-reference value (it can be void or integral::Returns<T...> for multiple results)
+        template<typename R, typename ...A>
+        class LuaFunction<R(A...)> : public LuaFunctionBase {
+        public:
+            using LuaFunctionBase::LuaFunctionBase;
+
+            // the arguments are pushed by value onto the lua stack
+            // throws CallerException on lua error and ArgumentException on invalid return type
+            inline R operator()(A ...arguments) const;
+        };
+
+        namespace exchanger {
+            template<typename F>
+            class Exchanger<LuaFunction<F>> {
+            public:
+                inline static LuaFunction<F> get(lua_State *luaState, int index);
+                inline static void push(lua_State *luaState, const LuaFunction<F> &luaFunction);
+            };
+        }
+
+        //--
+
+        inline lua_State * LuaFunctionBase::getLuaState() const {
+            return luaState_;
+        }
+
+        inline void LuaFunctionBase::push(lua_State *luaState) const {
+            lua_rawgeti(luaState, LUA_REGISTRYINDEX, reference_);
+        }
+
+        template<typename R, typename ...A>
+        inline R LuaFunction<R(A...)>::operator()(A ...arguments) const {
+            push(getLuaState());
+            // stack: function
+            // Caller<R, A...>::call pops the function
+            return Caller<R, A...>::call(getLuaState(), std::forward<A>(arguments)...);
+        }
+
+        namespace exchanger {
+            template<typename F>
+            inline LuaFunction<F> Exchanger<LuaFunction<F>>::get(lua_State *luaState, int index) {
+                return LuaFunction<F>(luaState, index);
+            }
+
+            template<typename F>
+            inline void Exchanger<LuaFunction<F>>::push(lua_State *luaState, const LuaFunction<F> &luaFunction) {
+                luaFunction.push(luaState);
+            }
+        }
+    }
+}
+
+#endif
@@ -46,6 +46,11 @@ namespace integral {
             template<typename R, typename ...A>
             inline decltype(auto) call(A &&...arguments) const;
 
+            // lua errors are propagated unchanged (no CallerException and no error message copy): the error value is raised again after the C++ frames of the bound function are unwound (see Caller)
+            // the thrown LuaError must not be handled by the bound function
+            template<typename R, typename ...A>
+            inline decltype(auto) callUnprotected(A &&...arguments) const;
+
         private:
             lua_State * const luaState_;
             const int luaAbsoluteStackIndex_;
@@ -67,6 +72,12 @@ namespace integral {
             return Caller<R, A...>::call(luaState_, std::forward<A>(arguments)...);
         }
 
+        template<typename R, typename ...A>
+        inline decltype(auto) LuaFunctionArgument::callUnprotected(A &&...arguments) const {
+            lua_pushvalue(luaState_, luaAbsoluteStackIndex_);
+            return Caller<R, A...>::callUnprotected(luaState_, std::forward<A>(arguments)...);
+        }
+
         namespace exchanger {
             inline LuaFunctionArgument Exchanger<LuaFunctionArgument>::get(lua_State *luaState, int index) {
                 // element at index stack position is not checked with lua_isfunction because it might not be a function and have a valid __call metamethod
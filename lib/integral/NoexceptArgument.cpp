@@ -0,0 +1,44 @@
+//
+//  NoexceptArgument.cpp
+//  integral
+//
+// MIT License
+//
+// Copyright (c) 2024 André Pereira Henriques (aphenriques (at) outlook (dot) com)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "NoexceptArgument.hpp"
+#include <cstring>
+#include <lua.hpp>
+
+namespace integral {
+    namespace detail {
+        int raiseArgumentTypeError(lua_State *luaState, int index, const char *expectedTypeName) {
+            const int gottenTypeCode = lua_type(luaState, index);
+            const char * const gottenTypeName = lua_typename(luaState, gottenTypeCode);
+            if (gottenTypeCode != LUA_TNUMBER || std::strcmp(expectedTypeName, gottenTypeName) != 0) {
+                lua_pushfstring(luaState, "%s expected, got %s", expectedTypeName, gottenTypeName);
+                return luaL_argerror(luaState, index, lua_tostring(luaState, -1));
+            } else {
+                return luaL_argerror(luaState, index, "integral number type expected, got floating-point number");
+            }
+        }
+    }
+}
@@ -0,0 +1,160 @@
+//
+//  NoexceptArgument.hpp
+//  integral
+//
+// MIT License
+//
+// Copyright (c) 2024 André Pereira Henriques (aphenriques (at) outlook (dot) com)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef integral_NoexceptArgument_hpp
+#define integral_NoexceptArgument_hpp
+
+#include <type_traits>
+#include <utility>
+#include <lua.hpp>
+#include "exchanger.hpp"
+#include "lua_compatibility.hpp"
+
+namespace integral {
+    namespace detail {
+        // arithmetic types (except bool) by value or const reference
+        template<typename T>
+        constexpr bool keIsNoexceptArithmeticArgument = std::is_arithmetic_v<std::decay_t<T>> && std::is_same_v<std::decay_t<T>, bool> == false && (std::is_reference_v<T> == false || std::is_const_v<std::remove_reference_t<T>> == true);
+
+        // bool by value or const reference
+        template<typename T>
+        constexpr bool keIsNoexceptBooleanArgument = std::is_same_v<std::decay_t<T>, bool> && (std::is_reference_v<T> == false || std::is_const_v<std::remove_reference_t<T>> == true);
+
+        // objects gotten by reference (exchanger::getObject)
+        template<typename T>
+        constexpr bool keIsNoexceptObjectArgument = std::is_reference_v<T> && std::is_class_v<std::decay_t<T>> && std::is_same_v<decltype(exchanger::get<T>(std::declval<lua_State *>(), 0)), std::decay_t<T> &>;
+
+        // Non-throwing argument conversion used by the noexcept fast path of StaticFunctionWrapper
+        // get(luaState, index, storage):
+        // - returns true if the argument was converted;
+        // - returns false if the argument requires the regular (throwing) conversion (e.g.: userdata or InlineCache miss); and
+        // - raises a Lua error (luaL_argerror) if the argument has an invalid type. Attention! It does not return in this case: storage must be trivially destructible
+        // getArgument(storage) returns the function argument
+        template<typename T, typename Enable = void>
+        class NoexceptArgument {
+        public:
+            static constexpr bool keIsSupported = false;
+        };
+
+        template<typename T>
+        class NoexceptArgument<T, std::enable_if_t<keIsNoexceptArithmeticArgument<T>>> {
+        public:
+            static constexpr bool keIsSupported = true;
+
+            using StorageType = std::decay_t<T>;
+
+            static bool get(lua_State *luaState, int index, StorageType &storage);
+
+            inline static const StorageType & getArgument(const StorageType &storage);
+        };
+
+        template<typename T>
+        class NoexceptArgument<T, std::enable_if_t<keIsNoexceptBooleanArgument<T>>> {
+        public:
+            static constexpr bool keIsSupported = true;
+
+            using StorageType = bool;
+
+            inline static bool get(lua_State *luaState, int index, StorageType &storage);
+
+            inline static const StorageType & getArgument(const StorageType &storage);
+        };
+
+        // only InlineCache hits are converted
+        template<typename T>
+        class NoexceptArgument<T, std::enable_if_t<keIsNoexceptObjectArgument<T>>> {
+        public:
+            static constexpr bool keIsSupported = true;
+
+            using StorageType = std::decay_t<T> *;
+
+            inline static bool get(lua_State *luaState, int index, StorageType &storage);
+
+            inline static std::decay_t<T> & getArgument(StorageType storage);
+        };
+
+        // same message as ArgumentException::createTypeErrorException
+        int raiseArgumentTypeError(lua_State *luaState, int index, const char *expectedTypeName);
+
+        //--
+
+        template<typename T>
+        bool NoexceptArgument<T, std::enable_if_t<keIsNoexceptArithmeticArgument<T>>>::get(lua_State *luaState, int index, StorageType &storage) {
+            if (lua_isuserdata(luaState, index) != 0) {
+                // type_manager conversion
+                return false;
+            }
+            int isNumber;
+            if constexpr (std::is_floating_point_v<StorageType> == true) {
+                storage = static_cast<StorageType>(lua_compatibility::tonumberx(luaState, index, &isNumber));
+            } else if constexpr (std::is_signed_v<StorageType> == true) {
+                storage = static_cast<StorageType>(lua_compatibility::tointegerx(luaState, index, &isNumber));
+            } else {
+                storage = static_cast<StorageType>(lua_compatibility::tounsignedx(luaState, index, &isNumber));
+            }
+            if (isNumber == 0) {
+                raiseArgumentTypeError(luaState, index, lua_typename(luaState, LUA_TNUMBER));
+            }
+            return true;
+        }
+
+        template<typename T>
+        inline const typename NoexceptArgument<T, std::enable_if_t<keIsNoexceptArithmeticArgument<T>>>::StorageType & NoexceptArgument<T, std::enable_if_t<keIsNoexceptArithmeticArgument<T>>>::getArgument(const StorageType &storage) {
+            return storage;
+        }
+
+        template<typename T>
+        inline bool NoexceptArgument<T, std::enable_if_t<keIsNoexceptBooleanArgument<T>>>::get(lua_State *luaState, int index, StorageType &storage) {
+            if (lua_isuserdata(luaState, index) != 0) {
+                // type_manager conversion
+                return false;
+            }
+            if (lua_isboolean(luaState, index) == 0) {
+                raiseArgumentTypeError(luaState, index, lua_typename(luaState, LUA_TBOOLEAN));
+            }
+            storage = lua_toboolean(luaState, index) != 0;
+            return true;
+        }
+
+        template<typename T>
+        inline const bool & NoexceptArgument<T, std::enable_if_t<keIsNoexceptBooleanArgument<T>>>::getArgument(const StorageType &storage) {
+            return storage;
+        }
+
+        template<typename T>
+        inline bool NoexceptArgument<T, std::enable_if_t<keIsNoexceptObjectArgument<T>>>::get(lua_State *luaState, int index, StorageType &storage) {
+            storage = exchanger::findObject<std::decay_t<T>>(luaState, index);
+            return storage != nullptr;
+        }
+
+        template<typename T>
+        inline std::decay_t<T> & NoexceptArgument<T, std::enable_if_t<keIsNoexceptObjectArgument<T>>>::getArgument(StorageType storage) {
+            return *storage;
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,319 @@
+//
+//  Overload.hpp
+//  integral
+//
+// MIT License
+//
+// Copyright (c) 2024 André Pereira Henriques (aphenriques (at) outlook (dot) com)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#ifndef integral_Overload_hpp
+#define integral_Overload_hpp
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <functional>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include <lua.hpp>
+#include "ArgumentException.hpp"
+#include "exchanger.hpp"
+#include "FunctionTraits.hpp"
+#include "LuaFunction.hpp"
+#include "LuaFunctionArgument.hpp"
+#include "LuaFunctionWrapper.hpp"
+#include "LuaIgnoredArgument.hpp"
+#include "TableView.hpp"
+
+namespace integral {
+    namespace detail {
+        // Lua type bit. LUA_TNONE (missing argument) is bit 0
+        // defined before the OverloadArgument specializations (constant expression)
+        inline constexpr unsigned getLuaTypeMask(int luaType) {
+            return 1u << (luaType + 1);
+        }
+
+        // Lua types accepted by an argument of (decayed) type T in an overload set (see exchanger::Exchanger specializations)
+        // The primary template is an object (userdata): it is also tested with the type manager (exchanger::isObject)
+        template<typename T, typename Enable = void>
+        class OverloadArgument {
+        public:
+            static constexpr bool keIsUserData = true;
+            static constexpr unsigned keLuaTypeMask = getLuaTypeMask(LUA_TUSERDATA);
+
+            inline static bool isObject(lua_State *luaState, int index);
+        };
+
+        // arguments matched by Lua type only
+        template<unsigned M>
+        class LuaTypeOverloadArgument {
+        public:
+            static constexpr bool keIsUserData = false;
+            static constexpr unsigned keLuaTypeMask = M;
+
+            inline static bool isObject(lua_State *luaState, int index);
+        };
+
+        template<typename T>
+        class OverloadArgument<T, std::enable_if_t<std::is_arithmetic_v<T> && std::is_same_v<T, bool> == false>> : public LuaTypeOverloadArgument<getLuaTypeMask(LUA_TNUMBER)> {};
+
+        template<>
+        class OverloadArgument<bool> : public LuaTypeOverloadArgument<getLuaTypeMask(LUA_TBOOLEAN)> {};
+
+        template<>
+        class OverloadArgument<const char *> : public LuaTypeOverloadArgument<getLuaTypeMask(LUA_TSTRING)> {};
+
+        template<>
+        class OverloadArgument<std::string_view> : public LuaTypeOverloadArgument<getLuaTypeMask(LUA_TSTRING)> {};
+
+        template<>
+        class OverloadArgument<std::string> : public LuaTypeOverloadArgument<getLuaTypeMask(LUA_TSTRING)> {};
+
+        template<typename T>
+        class OverloadArgument<std::vector<T>> : public LuaTypeOverloadArgument<getLuaTypeMask(LUA_TTABLE)> {};
+
+        template<typename T, std::size_t N>
+        class OverloadArgument<std::array<T, N>> : public LuaTypeOverloadArgument<getLuaTypeMask(LUA_TTABLE)> {};
+
+        template<typename T, typename U>
+        class OverloadArgument<std::unordered_map<T, U>> : public LuaTypeOverloadArgument<getLuaTypeMask(LUA_TTABLE)> {};
+
+        template<typename ...T>
+        class OverloadArgument<std::tuple<T...>> : public LuaTypeOverloadArgument<getLuaTypeMask(LUA_TTABLE)> {};
+
+        template<>
+        class OverloadArgument<LuaFunctionArgument> : public LuaTypeOverloadArgument<getLuaTypeMask(LUA_TFUNCTION)> {};
+
+        template<typename F>
+        class OverloadArgument<LuaFunction<F>> : public LuaTypeOverloadArgument<getLuaTypeMask(LUA_TFUNCTION)> {};
+
+        template<typename K, typename V>
+        class OverloadArgument<TableView<K, V>> : public LuaTypeOverloadArgument<getLuaTypeMask(LUA_TTABLE)> {};
+
+        template<>
+        class OverloadArgument<LuaIgnoredArgument> : public LuaTypeOverloadArgument<~0u> {};
+
+        template<typename T>
+        class OverloadArgument<std::optional<T>> {
+        public:
+            static constexpr bool keIsUserData = OverloadArgument<T>::keIsUserData;
+            static constexpr unsigned keLuaTypeMask = OverloadArgument<T>::keLuaTypeMask | getLuaTypeMask(LUA_TNONE) | getLuaTypeMask(LUA_TNIL);
+
+            inline static bool isObject(lua_State *luaState, int index);
+        };
+
+        template<typename S>
+        class OverloadCandidate;
+
+        template<typename R, typename ...A>
+        class OverloadCandidate<R(A...)> {
+        public:
+            static constexpr std::size_t keNumberOfArguments = sizeof...(A);
+            static constexpr bool keHasUserData = (OverloadArgument<std::decay_t<A>>::keIsUserData || ...);
+
+            // "luaTypes": Lua types of the arguments on the stack (LUA_TNONE for missing arguments). Its size is at least keNumberOfArguments
+            inline static bool isMatch(lua_State *luaState, int numberOfArguments, const int *luaTypes);
+
+            template<typename F>
+            inline static int call(lua_State *luaState, const F &function);
+
+        private:
+            template<std::size_t ...S>
+            inline static bool isLuaTypeMatch(const int *luaTypes, std::index_sequence<S...>);
+
+            template<std::size_t ...S>
+            inline static bool isObjectMatch(lua_State *luaState, std::index_sequence<S...>);
+
+            template<typename F, std::size_t ...S>
+            inline static int invoke(lua_State *luaState, const F &function, std::index_sequence<S...>);
+        };
+
+        // Set of functions (function pointers, member function pointers or functors) bound as a single Lua function
+        // The dispatch is resolved with the number of arguments and their Lua types (the masks are compile time constants). The first matching function in declaration order is called:
+        // 1. functions without object (userdata) arguments
+        // 2. functions with object arguments, which are also tested with the type manager (exchanger::isObject)
+        // Numbers are not distinguished: overloads that differ only by arithmetic types (e.g. int and double) are resolved by declaration order
+        // Overload can not be gotten with integral::get
+        template<typename ...F>
+        class Overload {
+        public:
+            static_assert(sizeof...(F) > 0, "empty overload set");
+
+            inline explicit Overload(F ...functions);
+
+            int call(lua_State *luaState) const;
+
+        private:
+            template<typename G>
+            using Candidate = OverloadCandidate<typename FunctionTraits<G>::Signature>;
+
+            static constexpr std::size_t keMaximumNumberOfArguments = std::max({Candidate<F>::keNumberOfArguments...});
+
+            std::tuple<F...> functions_;
+
+            // "U": tries only the functions with (true) or without (false) object arguments
+            template<bool U, std::size_t ...S>
+            inline bool callFirstMatch(lua_State *luaState, int numberOfArguments, const int *luaTypes, int &numberOfResults, std::index_sequence<S...>) const;
+
+            template<bool U, std::size_t I>
+            inline bool callIfMatch(lua_State *luaState, int numberOfArguments, const int *luaTypes, int &numberOfResults) const;
+        };
+
+        namespace exchanger {
+            template<typename ...F>
+            class Exchanger<Overload<F...>> {
+            public:
+                inline static void push(lua_State *luaState, Overload<F...> &&overload);
+                inline static void push(lua_State *luaState, const Overload<F...> &overload);
+
+            private:
+                template<typename O>
+                static void genericPush(lua_State *luaState, O &&overload);
+            };
+        }
+
+        //--
+
+        template<typename T, typename Enable>
+        inline bool OverloadArgument<T, Enable>::isObject(lua_State *luaState, int index) {
+            return exchanger::isObject<T>(luaState, index);
+        }
+
+        template<unsigned M>
+        inline bool LuaTypeOverloadArgument<M>::isObject(lua_State *, int) {
+            return true;
+        }
+
+        template<typename T>
+        inline bool OverloadArgument<std::optional<T>>::isObject(lua_State *luaState, int index) {
+            return lua_isnoneornil(luaState, index) != 0 || OverloadArgument<T>::isObject(luaState, index);
+        }
+
+        template<typename R, typename ...A>
+        inline bool OverloadCandidate<R(A...)>::isMatch(lua_State *luaState, int numberOfArguments, const int *luaTypes) {
+            if (static_cast<std::size_t>(numberOfArguments) <= keNumberOfArguments && isLuaTypeMatch(luaTypes, std::index_sequence_for<A...>()) == true) {
+                if constexpr (keHasUserData == true) {
+                    return isObjectMatch(luaState, std::index_sequence_for<A...>());
+                } else {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        template<typename R, typename ...A>
+        template<typename F>
+        inline int OverloadCandidate<R(A...)>::call(lua_State *luaState, const F &function) {
+            return invoke(luaState, function, std::index_sequence_for<A...>());
+        }
+
+        template<typename R, typename ...A>
+        template<std::size_t ...S>
+        // [[maybe_unused]]: see FunctionCaller<void, A...>::call
+        inline bool OverloadCandidate<R(A...)>::isLuaTypeMatch([[maybe_unused]] const int *luaTypes, std::index_sequence<S...>) {
+            return (((OverloadArgument<std::decay_t<A>>::keLuaTypeMask & getLuaTypeMask(luaTypes[S])) != 0) && ...);
+        }
+
+        template<typename R, typename ...A>
+        template<std::size_t ...S>
+        inline bool OverloadCandidate<R(A...)>::isObjectMatch([[maybe_unused]] lua_State *luaState, std::index_sequence<S...>) {
+            return (OverloadArgument<std::decay_t<A>>::isObject(luaState, S + 1) && ...);
+        }
+
+        template<typename R, typename ...A>
+        template<typename F, std::size_t ...S>
+        inline int OverloadCandidate<R(A...)>::invoke([[maybe_unused]] lua_State *luaState, const F &function, std::index_sequence<S...>) {
+            if constexpr (std::is_void_v<R> == true) {
+                std::invoke(function, exchanger::get<A>(luaState, S + 1)...);
+                return 0;
+            } else {
+                return exchanger::pushReturnValue<R>(luaState, std::invoke(function, exchanger::get<A>(luaState, S + 1)...));
+            }
+        }
+
+        template<typename ...F>
+        inline Overload<F...>::Overload(F ...functions) : functions_(std::move(functions)...) {}
+
+        template<typename ...F>
+        int Overload<F...>::call(lua_State *luaState) const {
+            const int numberOfArguments = lua_gettop(luaState);
+            // the Lua types are gotten once for every function
+            std::array<int, keMaximumNumberOfArguments> luaTypes;
+            for (int index = 1; index <= static_cast<int>(keMaximumNumberOfArguments); ++index) {
+                luaTypes[index - 1] = (index <= numberOfArguments) ? lua_type(luaState, index) : LUA_TNONE;
+            }
+            int numberOfResults = 0;
+            if (callFirstMatch<false>(luaState, numberOfArguments, luaTypes.data(), numberOfResults, std::index_sequence_for<F...>()) == true || callFirstMatch<true>(luaState, numberOfArguments, luaTypes.data(), numberOfResults, std::index_sequence_for<F...>()) == true) {
+                return numberOfResults;
+            }
+            throw ArgumentException::createOverloadException(luaState);
+        }
+
+        template<typename ...F>
+        template<bool U, std::size_t ...S>
+        inline bool Overload<F...>::callFirstMatch(lua_State *luaState, int numberOfArguments, const int *luaTypes, int &numberOfResults, std::index_sequence<S...>) const {
+            // short-circuit: stops at the first match
+            return (callIfMatch<U, S>(luaState, numberOfArguments, luaTypes, numberOfResults) || ...);
+        }
+
+        template<typename ...F>
+        template<bool U, std::size_t I>
+        inline bool Overload<F...>::callIfMatch([[maybe_unused]] lua_State *luaState, [[maybe_unused]] int numberOfArguments, [[maybe_unused]] const int *luaTypes, [[maybe_unused]] int &numberOfResults) const {
+            using FunctionCandidate = Candidate<std::tuple_element_t<I, std::tuple<F...>>>;
+            if constexpr (FunctionCandidate::keHasUserData == U) {
+                if (FunctionCandidate::isMatch(luaState, numberOfArguments, luaTypes) == true) {
+                    numberOfResults = FunctionCandidate::call(luaState, std::get<I>(functions_));
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        namespace exchanger {
+            template<typename ...F>
+            inline void Exchanger<Overload<F...>>::push(lua_State *luaState, Overload<F...> &&overload) {
+                genericPush(luaState, std::move(overload));
+            }
+
+            template<typename ...F>
+            inline void Exchanger<Overload<F...>>::push(lua_State *luaState, const Overload<F...> &overload) {
+                genericPush(luaState, overload);
+            }
+
+            template<typename ...F>
+            template<typename O>
+            void Exchanger<Overload<F...>>::genericPush(lua_State *luaState, O &&overload) {
+                exchanger::push<LuaFunctionWrapper>(luaState, [lambdaOverload = std::forward<O>(overload)](lua_State *lambdaLuaState) -> int {
+                    return lambdaOverload.call(lambdaLuaState);
+                });
+            }
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,81 @@
+//
+//  PersistentReference.cpp
+//  integral
+//
+// MIT License
+//
+// Copyright (c) 2024 André Pereira Henriques (aphenriques (at) outlook (dot) com)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include "PersistentReference.hpp"
+#include <string>
+#include <utility>
+#include <lua.hpp>
+
+namespace integral::detail {
+    PersistentReference::PersistentReference(PersistentReference &&persistentReference) :
+        luaState_(persistentReference.luaState_),
+        reference_(persistentReference.reference_),
+        referenceString_(std::move(persistentReference.referenceString_))
+    {
+        persistentReference.reference_ = LUA_NOREF;
+    }
+
+    PersistentReference & PersistentReference::operator=(PersistentReference &&persistentReference) {
+        if (this != &persistentReference) {
+            luaL_unref(luaState_, LUA_REGISTRYINDEX, reference_);
+            luaState_ = persistentReference.luaState_;
+            reference_ = persistentReference.reference_;
+            referenceString_ = std::move(persistentReference.referenceString_);
+            persistentReference.reference_ = LUA_NOREF;
+        }
+        return *this;
+    }
+
+    PersistentReference::PersistentReference(lua_State *luaState, std::string referenceString) :
+        luaState_(luaState),
+        // luaL_ref returns LUA_REFNIL (no registry slot) if the value is nil
+        reference_(luaL_ref(luaState, LUA_REGISTRYINDEX)),
+        referenceString_(std::move(referenceString))
+    {}
+
+    PersistentReference::~PersistentReference() {
+        // luaL_unref ignores LUA_NOREF (moved reference) and LUA_REFNIL
+        luaL_unref(luaState_, LUA_REGISTRYINDEX, reference_);
+    }
+
+    bool PersistentReference::isNil() const {
+        push();
+        // stack: ?
+        const bool isNilValue = lua_isnil(getLuaState(), -1) != 0;
+        lua_pop(getLuaState(), 1);
+        // stack:
+        return isNilValue;
+    }
+
+    void PersistentReference::replace() {
+        // stack: value
+        // the slot is released instead of overwritten: lua 5.1 luaL_ref finds free slots with lua_objlen, which nil values in used slots would mislead
+        luaL_unref(getLuaState(), LUA_REGISTRYINDEX, reference_);
+        reference_ = luaL_ref(getLuaState(), LUA_REGISTRYINDEX);
+        // stack:
+    }
+}
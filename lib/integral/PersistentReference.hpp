@@ -0,0 +1,182 @@
+//
+//  PersistentReference.hpp
+//  integral
+//
+// MIT License
+//
+// Copyright (c) 2024 André Pereira Henriques (aphenriques (at) outlook (dot) com)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#ifndef integral_PersistentReference_hpp
+#define integral_PersistentReference_hpp
+
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <lua.hpp>
+#include "ArgumentException.hpp"
+#include "Caller.hpp"
+#include "exchanger.hpp"
+#include "ReferenceBase.hpp"
+
+namespace integral::detail {
+    // value resolved once (see Reference::pin) and kept in a lua registry slot (luaL_ref) until destruction
+    // slots released by luaL_unref are kept in the registry free list and reused by luaL_ref
+    // a PersistentReference must not outlive its lua_State
+    class PersistentReference {
+    public:
+        // non-copyable
+        PersistentReference(const PersistentReference &) = delete;
+        PersistentReference & operator=(const PersistentReference &) = delete;
+
+        // moveable
+        PersistentReference(PersistentReference &&persistentReference);
+        PersistentReference & operator=(PersistentReference &&persistentReference);
+
+        // stack argument: value (it is popped)
+        // "referenceString": path of the value (used in exception messages)
+        PersistentReference(lua_State *luaState, std::string referenceString);
+
+        ~PersistentReference();
+
+        inline lua_State * getLuaState() const;
+        inline void push() const;
+        bool isNil() const;
+        inline const std::string & getReferenceString() const;
+
+        // replaces the pinned value. The variable the reference was pinned from is not modified
+        template<typename T, typename ...A>
+        PersistentReference & emplace(A &&...arguments);
+
+        // replaces the pinned value. The variable the reference was pinned from is not modified
+        template<typename V>
+        inline PersistentReference & set(V &&value);
+
+        template<typename V>
+        decltype(auto) get() const;
+
+        // see Reference::with
+        template<typename V, typename F>
+        auto with(F &&function) const;
+
+        // see Reference::operator V
+        template<typename V>
+        inline operator V() const;
+
+        // the arguments are pushed by value onto the lua stack
+        // "R" can be integral::Returns<T...> to get multiple results (see integral::call)
+        template<typename R, typename ...A>
+        decltype(auto) call(A &&...arguments) const;
+
+    private:
+        lua_State *luaState_;
+        int reference_;
+        std::string referenceString_;
+
+        // stack argument: value (it is popped)
+        void replace();
+    };
+
+    //--
+
+    inline lua_State * PersistentReference::getLuaState() const {
+        return luaState_;
+    }
+
+    inline void PersistentReference::push() const {
+        lua_rawgeti(getLuaState(), LUA_REGISTRYINDEX, reference_);
+    }
+
+    inline const std::string & PersistentReference::getReferenceString() const {
+        return referenceString_;
+    }
+
+    template<typename T, typename ...A>
+    PersistentReference & PersistentReference::emplace(A &&...arguments) {
+        exchanger::push<T>(getLuaState(), std::forward<A>(arguments)...);
+        // stack: value
+        replace();
+        // stack:
+        return *this;
+    }
+
+    template<typename V>
+    inline PersistentReference & PersistentReference::set(V &&value) {
+        return emplace<std::decay_t<V>>(std::forward<V>(value));
+    }
+
+    template<typename V>
+    decltype(auto) PersistentReference::get() const {
+        // https://www.lua.org/manual/5.4/manual.html#4.1.3
+        static_assert(
+            std::is_same_v<std::decay_t<V>, std::decay_t<const char *>> == false,
+            "storing a pointer to a string removed from the stack is unsafe"
+        );
+        static_assert(
+            std::is_same_v<std::decay_t<V>, std::decay_t<std::string_view>> == false,
+            "storing a pointer to a string removed from the stack is unsafe"
+        );
+        push();
+        // stack: ?
+        try {
+            decltype(auto) returnValue = exchanger::get<V>(getLuaState(), -1);
+            // stack: value
+            lua_pop(getLuaState(), 1);
+            // stack:
+            return returnValue;
+        } catch (const ArgumentException &argumentException) {
+            // stack: ?
+            lua_pop(getLuaState(), 1);
+            // stack:
+            throw ReferenceException(__FILE__, __LINE__, __func__, std::string("[integral] invalid type getting persistent reference " ) + getReferenceString() + ": " + argumentException.what());
+        }
+    }
+
+    template<typename V, typename F>
+    auto PersistentReference::with(F &&function) const {
+        push();
+        // stack: ?
+        return callWithValue<V>(getLuaState(), std::forward<F>(function), [this]() {
+            return "persistent reference " + getReferenceString();
+        });
+    }
+
+    template<typename V>
+    inline PersistentReference::operator V() const {
+        return get<V>();
+    }
+
+    template<typename R, typename ...A>
+    decltype(auto) PersistentReference::call(A &&...arguments) const {
+        push();
+        // stack: ?
+        try {
+            // detail::Caller<R, A...>::call pops the first element of the stack
+            return detail::Caller<R, A...>::call(getLuaState(), std::forward<A>(arguments)...);
+        } catch (const ArgumentException &argumentException) {
+            throw ReferenceException(__FILE__, __LINE__, __func__, std::string("[integral] invalid type calling function persistent reference " ) + getReferenceString() + ": " + argumentException.what());
+        } catch (const CallerException &callerException) {
+            throw ReferenceException(__FILE__, __LINE__, __func__, std::string("[integral] error calling function persistent reference " ) + getReferenceString() + ": " + callerException.what());
+        }
+    }
+}
+
+#endif
@@ -30,6 +30,9 @@
 #include "ReferenceBase.hpp"
 #include "ArgumentException.hpp"
 #include "Caller.hpp"
+#include "PersistentReference.hpp"
+#include "StaticFunctionWrapper.hpp"
+#include "type_manager.hpp"
 
 namespace integral::detail {
     template<typename K, typename C>
@@ -54,12 +57,22 @@ namespace integral::detail {
         template<typename F, typename ...E, std::size_t ...I>
         inline Reference<K, C> & setFunction(F &&function, DefaultArgument<E, I> &&...defaultArguments);
 
+        // function pointer or member function pointer bound at compile time (stateless lua_CFunction)
+        template<auto F>
+        inline Reference<K, C> & setFunction();
+
         template<typename F>
         inline Reference<K, C> & setLuaFunction(F &&function);
 
         template<typename V>
         decltype(auto) get() const;
 
+        // scoped access: the value is kept on the lua stack while "function" is called with it
+        // "V" can be std::string_view or const char * (no string copy): the value must not be used after the call
+        // returns the result of function(value) by value
+        template<typename V, typename F>
+        auto with(F &&function) const;
+
         // the conversion operator does not return a reference to an object
         // storing a reference to a Lua object is unsafe because it might be collected
         // Reference::get returns a reference to an object but it is not meant to be stored
@@ -67,8 +80,13 @@ namespace integral::detail {
         inline operator V() const;
 
         // the arguments are pushed by value onto the lua stack
+        // "R" can be integral::Returns<T...> to get multiple results (see integral::call)
         template<typename R, typename ...A>
         decltype(auto) call(A &&...arguments);
+
+        // resolves the reference path once: the returned PersistentReference accesses the current value with a single registry lookup
+        // later changes to the path (e.g.: reassigning a table in it) are not seen by the PersistentReference
+        PersistentReference pin() const;
     };
 
     //--
@@ -116,7 +134,7 @@ namespace integral::detail {
             // stack: chainedReferenceTable | key
             exchanger::push<T>(getLuaState(), std::forward<A>(arguments)...);
             // stack: chainedReferenceTable | key | value
-            lua_rawset(getLuaState(), -3);
+            detail::type_manager::rawset(getLuaState());
             // stack: chainedReferenceTable
             lua_pop(getLuaState(), 1);
             // stack:
@@ -146,6 +164,12 @@ namespace integral::detail {
         return set(makeFunctionWrapper(std::forward<F>(function), std::move(defaultArguments)...));
     }
 
+    template<typename K, typename C>
+    template<auto F>
+    inline Reference<K, C> & Reference<K, C>::setFunction() {
+        return set(detail::StaticFunctionWrapper<F>());
+    }
+
     template<typename K, typename C>
     template<typename F>
     inline Reference<K, C> & Reference<K, C>::setLuaFunction(F &&function) {
@@ -180,6 +204,16 @@ namespace integral::detail {
         }
     }
 
+    template<typename K, typename C>
+    template<typename V, typename F>
+    auto Reference<K, C>::with(F &&function) const {
+        push();
+        // stack: ?
+        return callWithValue<V>(getLuaState(), std::forward<F>(function), [this]() {
+            return "reference " + ReferenceBase<Reference<K, C>>::getReferenceString();
+        });
+    }
+
     template<typename K, typename C>
     template<typename V>
     inline Reference<K, C>::operator V() const {
@@ -200,6 +234,13 @@ namespace integral::detail {
             throw ReferenceException(__FILE__, __LINE__, __func__, std::string("[integral] error calling function reference " ) + ReferenceBase<Reference<K, C>>::getReferenceString() + ": " + callerException.what());
         }
     }
+
+    template<typename K, typename C>
+    PersistentReference Reference<K, C>::pin() const {
+        push();
+        // stack: value
+        return PersistentReference(getLuaState(), ReferenceBase<Reference<K, C>>::getReferenceString());
+    }
 }
 
 #endif
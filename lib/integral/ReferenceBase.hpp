@@ -27,11 +27,13 @@
 #ifndef integral_ReferenceBase_hpp
 #define integral_ReferenceBase_hpp
 
+#include <string>
 #include <type_traits>
 #include <utility>
 #include <lua.hpp>
 #include <exception/Exception.hpp>
 #include <exception/TemplateClassException.hpp>
+#include "ArgumentException.hpp"
 #include "exchanger.hpp"
 #include "serializer.hpp"
 
@@ -74,6 +76,12 @@ namespace integral::detail {
 
     using ReferenceException = exception::TemplateClassException<ReferenceBase, exception::RuntimeException>;
 
+    // scoped access shared by Reference::with and PersistentReference::with
+    // stack argument: value (it is popped before returning or throwing)
+    // getDescription: std::string() (e.g.: "reference " + getReferenceString()). It is only called on a type error
+    template<typename V, typename F, typename D>
+    auto callWithValue(lua_State *luaState, F &&function, const D &getDescription);
+
     template<template<typename, typename> typename T, typename K, typename C>
     template<typename L, typename D>
     inline ReferenceBase<T<K, C>>::ReferenceBase(L &&key, D &&chainedReference) :
@@ -119,6 +127,40 @@ namespace integral::detail {
             throw ReferenceException(__FILE__, __LINE__, __func__, std::string("[integral] reference ") + getChainedReference().getReferenceString() + " is not a table");
         }
     }
+
+    template<typename V, typename F, typename D>
+    auto callWithValue(lua_State *luaState, F &&function, const D &getDescription) {
+        // stack: ?
+        auto getValue = [luaState, &getDescription]() -> decltype(auto) {
+            try {
+                return exchanger::get<V>(luaState, -1);
+            } catch (const ArgumentException &argumentException) {
+                // stack: ?
+                lua_pop(luaState, 1);
+                // stack:
+                throw ReferenceException(__FILE__, __LINE__, "with", "[integral] invalid type getting " + getDescription() + ": " + argumentException.what());
+            }
+        };
+        decltype(auto) value = getValue();
+        // stack: value
+        try {
+            if constexpr (std::is_void_v<std::invoke_result_t<F, decltype((value))>> == true) {
+                std::forward<F>(function)(value);
+                lua_pop(luaState, 1);
+                // stack:
+            } else {
+                auto returnValue = std::forward<F>(function)(value);
+                lua_pop(luaState, 1);
+                // stack:
+                return returnValue;
+            }
+        } catch (...) {
+            // stack: value
+            lua_pop(luaState, 1);
+            // stack:
+            throw;
+        }
+    }
 }
 
 #endif
@@ -0,0 +1,52 @@
+//
+//  Returns.hpp
+//  integral
+//
+// MIT License
+//
+// Copyright (c) 2024 André Pereira Henriques (aphenriques (at) outlook (dot) com)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#ifndef integral_Returns_hpp
+#define integral_Returns_hpp
+
+#include <cstddef>
+#include <tuple>
+
+namespace integral {
+    // Multiple return values of a bound function.
+    // Each element is pushed as a separate value onto the lua stack (no table is created, unlike std::tuple).
+    // e.g.: integral::Returns<double, double, double> getPosition();
+    template<typename ...T>
+    class Returns : public std::tuple<T...> {
+    public:
+        using std::tuple<T...>::tuple;
+    };
+}
+
+// structured bindings: auto [x, y, z] = reference.call<integral::Returns<double, double, double>>();
+template<typename ...T>
+struct std::tuple_size<integral::Returns<T...>> : public std::tuple_size<std::tuple<T...>> {};
+
+template<std::size_t I, typename ...T>
+struct std::tuple_element<I, integral::Returns<T...>> : public std::tuple_element<I, std::tuple<T...>> {};
+
+#endif
@@ -35,6 +35,7 @@
 #include <exception/Exception.hpp>
 #include "core.hpp"
 #include "GlobalReference.hpp"
+#include "PersistentReference.hpp"
 #include "Reference.hpp"
 
 namespace integral {
@@ -78,6 +79,12 @@ namespace integral {
         template<typename F>
         inline void defineInheritance(F &&typeFunction) const;
 
+        template<typename D, typename B>
+        inline void defineFlattenedInheritance() const;
+
+        template<typename F>
+        inline void defineFlattenedInheritance(F &&typeFunction) const;
+
     private:
         static const char * const kErrorStackArgument;
         static const char * const kErrorStackMiscellanous;
@@ -96,6 +103,7 @@ namespace integral {
 
     using StateException = exception::ClassException<StateView, exception::RuntimeException>;
     using ReferenceException = detail::ReferenceException;
+    using PersistentReference = detail::PersistentReference;
 
     //--
 
@@ -131,6 +139,16 @@ namespace integral {
     inline void StateView::defineInheritance(F &&typeFunction) const {
         integral::defineInheritance(getLuaState(), std::forward<F>(typeFunction));
     }
+
+    template<typename D, typename B>
+    inline void StateView::defineFlattenedInheritance() const {
+        integral::defineFlattenedInheritance<D, B>(getLuaState());
+    }
+
+    template<typename F>
+    inline void StateView::defineFlattenedInheritance(F &&typeFunction) const {
+        integral::defineFlattenedInheritance(getLuaState(), std::forward<F>(typeFunction));
+    }
 }
 
 #endif
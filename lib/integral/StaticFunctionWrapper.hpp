@@ -0,0 +1,162 @@
+//
+//  StaticFunctionWrapper.hpp
+//  integral
+//
+// MIT License
+//
+// Copyright (c) 2024 André Pereira Henriques (aphenriques (at) outlook (dot) com)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef integral_StaticFunctionWrapper_hpp
+#define integral_StaticFunctionWrapper_hpp
+
+#include <cstddef>
+#include <functional>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <lua.hpp>
+#include "ArgumentException.hpp"
+#include "exchanger.hpp"
+#include "FunctionTraits.hpp"
+#include "NoexceptArgument.hpp"
+
+namespace integral {
+    namespace detail {
+        // "auto F": function pointer or member function pointer bound at compile time
+        // It is pushed as a stateless lua_CFunction: no upvalues, no std::function and no heap allocation
+        // StaticFunctionWrapper can not be gotten with integral::get
+        template<auto F, typename S = typename FunctionTraits<decltype(F)>::Signature>
+        class StaticFunctionWrapper;
+
+        // noexcept fast path: F is noexcept, every argument has a NoexceptArgument conversion and the return type is pushed without throwing (void or arithmetic)
+        // the fast path has no try region: invalid argument types raise Lua errors directly (luaL_argerror)
+        // the exception translating call is still used for excessive arguments, userdata conversions (type_manager) and InlineCache misses
+        template<auto F, typename R, typename ...A>
+        class StaticFunctionWrapper<F, R(A...)> {
+        public:
+            static constexpr bool keIsNoexcept = std::is_nothrow_invocable_v<decltype(F), A...> && (std::is_void_v<R> || std::is_arithmetic_v<R>) && (NoexceptArgument<A>::keIsSupported && ...);
+
+            // lua_CFunction. Exceptions are translated to Lua errors
+            static int call(lua_State *luaState);
+
+            // lua_CFunction. Requires keIsNoexcept
+            static int callNoexcept(lua_State *luaState);
+
+            // callNoexcept if keIsNoexcept; call otherwise
+            inline static constexpr lua_CFunction getLuaFunction();
+
+        private:
+            template<std::size_t ...S>
+            inline static int invoke(lua_State *luaState, std::index_sequence<S...>);
+
+            template<std::size_t ...S>
+            inline static int invokeNoexcept(lua_State *luaState, std::index_sequence<S...>);
+        };
+
+        namespace exchanger {
+            template<auto F, typename S>
+            class Exchanger<StaticFunctionWrapper<F, S>> {
+            public:
+                inline static void push(lua_State *luaState);
+                inline static void push(lua_State *luaState, const StaticFunctionWrapper<F, S> &staticFunctionWrapper);
+            };
+        }
+
+        //--
+
+        template<auto F, typename R, typename ...A>
+        int StaticFunctionWrapper<F, R(A...)>::call(lua_State *luaState) {
+            return exchanger::callLuaFunction(luaState, [](lua_State *lambdaLuaState) -> int {
+                // replicate code of maximum number of parameters checking in Exchanger<FunctionWrapper<R(A...), M>>::genericPush
+                const std::size_t numberOfArgumentsOnStack = static_cast<std::size_t>(lua_gettop(lambdaLuaState));
+                constexpr std::size_t keCppNumberOfArguments = sizeof...(A);
+                if (numberOfArgumentsOnStack <= keCppNumberOfArguments) {
+                    return invoke(lambdaLuaState, std::make_index_sequence<keCppNumberOfArguments>());
+                } else {
+                    throw ArgumentException(lambdaLuaState, keCppNumberOfArguments, numberOfArgumentsOnStack);
+                }
+            });
+        }
+
+        template<auto F, typename R, typename ...A>
+        int StaticFunctionWrapper<F, R(A...)>::callNoexcept(lua_State *luaState) {
+            static_assert(keIsNoexcept == true, "function does not have a noexcept fast path");
+            return invokeNoexcept(luaState, std::index_sequence_for<A...>());
+        }
+
+        template<auto F, typename R, typename ...A>
+        inline constexpr lua_CFunction StaticFunctionWrapper<F, R(A...)>::getLuaFunction() {
+            if constexpr (keIsNoexcept == true) {
+                return &callNoexcept;
+            } else {
+                return &call;
+            }
+        }
+
+        template<auto F, typename R, typename ...A>
+        template<std::size_t ...S>
+        // [[maybe_unused]]: see FunctionCaller<void, A...>::call
+        inline int StaticFunctionWrapper<F, R(A...)>::invoke([[maybe_unused]] lua_State *luaState, std::index_sequence<S...>) {
+            if constexpr (std::is_void_v<R> == true) {
+                std::invoke(F, exchanger::get<A>(luaState, S + 1)...);
+                return 0;
+            } else {
+                return exchanger::pushReturnValue<R>(luaState, std::invoke(F, exchanger::get<A>(luaState, S + 1)...));
+            }
+        }
+
+        template<auto F, typename R, typename ...A>
+        template<std::size_t ...S>
+        inline int StaticFunctionWrapper<F, R(A...)>::invokeNoexcept(lua_State *luaState, std::index_sequence<S...>) {
+            if (static_cast<std::size_t>(lua_gettop(luaState)) <= sizeof...(A)) {
+                // trivially destructible: NoexceptArgument::get might not return (Lua error)
+                [[maybe_unused]] std::tuple<typename NoexceptArgument<A>::StorageType...> arguments;
+                static_assert(std::is_trivially_destructible_v<decltype(arguments)> == true, "unexpected NoexceptArgument storage type");
+                // the conversion stops at the first argument that requires the regular conversion
+                if ((NoexceptArgument<A>::get(luaState, S + 1, std::get<S>(arguments)) && ...)) {
+                    if constexpr (std::is_void_v<R> == true) {
+                        std::invoke(F, NoexceptArgument<A>::getArgument(std::get<S>(arguments))...);
+                        return 0;
+                    } else {
+                        // exchanger::push checks the stack (it might throw)
+                        exchanger::Exchanger<R>::push(luaState, std::invoke(F, NoexceptArgument<A>::getArgument(std::get<S>(arguments))...));
+                        return 1;
+                    }
+                }
+            }
+            return call(luaState);
+        }
+
+        namespace exchanger {
+            template<auto F, typename S>
+            inline void Exchanger<StaticFunctionWrapper<F, S>>::push(lua_State *luaState) {
+                lua_pushcclosure(luaState, StaticFunctionWrapper<F, S>::getLuaFunction(), 0);
+            }
+
+            template<auto F, typename S>
+            inline void Exchanger<StaticFunctionWrapper<F, S>>::push(lua_State *luaState, const StaticFunctionWrapper<F, S> &) {
+                push(luaState);
+            }
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,276 @@
+//
+//  TableView.hpp
+//  integral
+//
+// MIT License
+//
+// Copyright (c) 2024 André Pereira Henriques (aphenriques (at) outlook (dot) com)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#ifndef integral_TableView_hpp
+#define integral_TableView_hpp
+
+#include <cstddef>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <lua.hpp>
+#include "ArgumentException.hpp"
+#include "exchanger.hpp"
+#include "lua_compatibility.hpp"
+
+namespace integral {
+    namespace detail {
+        // key and value of the current TableView iteration
+        // stack: key | value
+        class TableEntry {
+        public:
+            inline explicit TableEntry(lua_State *luaState);
+
+            // the key is converted from a copy (lua_tostring would change a number key in place and corrupt lua_next)
+            template<typename K>
+            K getKey() const;
+
+            template<typename V>
+            decltype(auto) getValue() const;
+
+        private:
+            lua_State *luaState_;
+        };
+
+        // Proxy to a table in the lua stack: elements are converted on demand (no table copy and no heap allocation)
+        // The object of this class cannot be stored, it only points to a table in the stack.
+        // "K" and "V": key and value types of the iteration (std::pair<K, V>). If they are void, the iteration yields TableEntry
+        template<typename K = void, typename V = void>
+        class TableView {
+        public:
+            // iteration with lua_next: key and value are kept on the top of the stack while the iterator is not at the end (they are popped on destruction)
+            // the stack must be balanced in each loop step. Only one iteration of a table can be active at a time
+            class Iterator {
+            public:
+                // non-copyable
+                Iterator(const Iterator &) = delete;
+                Iterator & operator=(const Iterator &) = delete;
+
+                inline Iterator(Iterator &&iterator);
+
+                // "isEnd": end iterator (nothing is pushed)
+                inline Iterator(lua_State *luaState, int tableIndex, bool isEnd);
+
+                inline ~Iterator();
+
+                inline decltype(auto) operator*() const;
+                inline Iterator & operator++();
+                inline bool operator==(const Iterator &iterator) const;
+                inline bool operator!=(const Iterator &iterator) const;
+
+            private:
+                lua_State *luaState_;
+                int tableIndex_;
+                bool isActive_;
+
+                // stack: key
+                inline void next();
+            };
+
+            // throws ArgumentException if the element at index is not a table
+            TableView(lua_State *luaState, int index);
+
+            inline lua_State * getLuaState() const;
+
+            // raw length (lua_rawlen)
+            inline std::size_t size() const;
+
+            // raw access (no metamethods)
+            // "W": value type. It is converted when called
+            // throws ArgumentException if the value cannot be converted to "W"
+            template<typename W, typename L>
+            decltype(auto) get(L &&key) const;
+
+            inline Iterator begin() const;
+            inline Iterator end() const;
+
+        private:
+            lua_State * const luaState_;
+            const int luaAbsoluteStackIndex_;
+        };
+
+        namespace exchanger {
+            template<typename K, typename V>
+            class Exchanger<TableView<K, V>> {
+            public:
+                inline static TableView<K, V> get(lua_State *luaState, int index);
+            };
+        }
+
+        //--
+
+        inline TableEntry::TableEntry(lua_State *luaState) : luaState_(luaState) {}
+
+        template<typename K>
+        K TableEntry::getKey() const {
+            static_assert(std::is_same_v<std::decay_t<K>, const char *> == false && std::is_same_v<std::decay_t<K>, std::string_view> == false, "storing a pointer to a string removed from the stack is unsafe");
+            // stack: key | value
+            lua_pushvalue(luaState_, -2);
+            // stack: key | value | key
+            try {
+                K key = exchanger::get<K>(luaState_, -1);
+                lua_pop(luaState_, 1);
+                // stack: key | value
+                return key;
+            } catch (const ArgumentException &) {
+                lua_pop(luaState_, 1);
+                // stack: key | value
+                throw;
+            }
+        }
+
+        template<typename V>
+        decltype(auto) TableEntry::getValue() const {
+            // stack: key | value
+            return exchanger::get<V>(luaState_, -1);
+        }
+
+        template<typename K, typename V>
+        inline TableView<K, V>::Iterator::Iterator(Iterator &&iterator) : luaState_(iterator.luaState_), tableIndex_(iterator.tableIndex_), isActive_(iterator.isActive_) {
+            iterator.isActive_ = false;
+        }
+
+        template<typename K, typename V>
+        inline TableView<K, V>::Iterator::Iterator(lua_State *luaState, int tableIndex, bool isEnd) : luaState_(luaState), tableIndex_(tableIndex), isActive_(false) {
+            if (isEnd == false) {
+                lua_pushnil(luaState_);
+                // stack: nil
+                next();
+            }
+        }
+
+        template<typename K, typename V>
+        inline TableView<K, V>::Iterator::~Iterator() {
+            if (isActive_ == true) {
+                // stack: key | value
+                lua_pop(luaState_, 2);
+            }
+        }
+
+        template<typename K, typename V>
+        inline decltype(auto) TableView<K, V>::Iterator::operator*() const {
+            if constexpr (std::is_void_v<K> == true || std::is_void_v<V> == true) {
+                static_assert(std::is_void_v<K> == true && std::is_void_v<V> == true, "K and V must be both either void or not");
+                return TableEntry(luaState_);
+            } else {
+                const TableEntry tableEntry(luaState_);
+                // the key is converted before the value (lua_tostring)
+                K key = tableEntry.getKey<K>();
+                return std::pair<K, V>(std::move(key), tableEntry.getValue<V>());
+            }
+        }
+
+        template<typename K, typename V>
+        inline typename TableView<K, V>::Iterator & TableView<K, V>::Iterator::operator++() {
+            // stack: key | value
+            lua_pop(luaState_, 1);
+            // stack: key
+            next();
+            return *this;
+        }
+
+        template<typename K, typename V>
+        inline bool TableView<K, V>::Iterator::operator==(const Iterator &iterator) const {
+            // only an iteration of a table can be active
+            return isActive_ == iterator.isActive_;
+        }
+
+        template<typename K, typename V>
+        inline bool TableView<K, V>::Iterator::operator!=(const Iterator &iterator) const {
+            return (*this == iterator) == false;
+        }
+
+        template<typename K, typename V>
+        inline void TableView<K, V>::Iterator::next() {
+            // stack: key
+            // lua_next pops the key
+            isActive_ = lua_next(luaState_, tableIndex_) != 0;
+            // stack: key | value (isActive_ == true)
+        }
+
+        template<typename K, typename V>
+        TableView<K, V>::TableView(lua_State *luaState, int index) : luaState_(luaState), luaAbsoluteStackIndex_(lua_compatibility::absindex(luaState, index)) {
+            if (lua_istable(luaState, index) == 0) {
+                throw ArgumentException::createTypeErrorException(luaState, index, lua_typename(luaState, LUA_TTABLE));
+            }
+        }
+
+        template<typename K, typename V>
+        inline lua_State * TableView<K, V>::getLuaState() const {
+            return luaState_;
+        }
+
+        template<typename K, typename V>
+        inline std::size_t TableView<K, V>::size() const {
+            return static_cast<std::size_t>(lua_compatibility::rawlen(luaState_, luaAbsoluteStackIndex_));
+        }
+
+        template<typename K, typename V>
+        template<typename W, typename L>
+        decltype(auto) TableView<K, V>::get(L &&key) const {
+            // https://www.lua.org/manual/5.4/manual.html#4.1.3
+            static_assert(std::is_same_v<std::decay_t<W>, const char *> == false && std::is_same_v<std::decay_t<W>, std::string_view> == false, "storing a pointer to a string removed from the stack is unsafe");
+            if constexpr (std::is_integral_v<std::decay_t<L>> == true && std::is_same_v<std::decay_t<L>, bool> == false) {
+                lua_compatibility::rawgeti(luaState_, luaAbsoluteStackIndex_, static_cast<lua_Integer>(key));
+            } else {
+                exchanger::pushCopy(luaState_, std::forward<L>(key));
+                // stack: key
+                lua_rawget(luaState_, luaAbsoluteStackIndex_);
+            }
+            // stack: value (?)
+            try {
+                decltype(auto) returnValue = exchanger::get<W>(luaState_, -1);
+                lua_pop(luaState_, 1);
+                // stack:
+                return returnValue;
+            } catch (const ArgumentException &) {
+                lua_pop(luaState_, 1);
+                // stack:
+                throw;
+            }
+        }
+
+        template<typename K, typename V>
+        inline typename TableView<K, V>::Iterator TableView<K, V>::begin() const {
+            return Iterator(luaState_, luaAbsoluteStackIndex_, false);
+        }
+
+        template<typename K, typename V>
+        inline typename TableView<K, V>::Iterator TableView<K, V>::end() const {
+            return Iterator(luaState_, luaAbsoluteStackIndex_, true);
+        }
+
+        namespace exchanger {
+            template<typename K, typename V>
+            inline TableView<K, V> Exchanger<TableView<K, V>>::get(lua_State *luaState, int index) {
+                return TableView<K, V>(luaState, index);
+            }
+        }
+    }
+}
+
+#endif
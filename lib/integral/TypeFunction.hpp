@@ -0,0 +1,124 @@
+//
+//  TypeFunction.hpp
+//  integral
+//
+// MIT License
+//
+// Copyright (c) 2024 André Pereira Henriques (aphenriques (at) outlook (dot) com)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#ifndef integral_TypeFunction_hpp
+#define integral_TypeFunction_hpp
+
+#include <functional>
+#include <utility>
+#include "basic.hpp"
+#include "UserDataWrapper.hpp"
+
+namespace integral {
+    namespace detail {
+        // Native type conversion function (pointer to pointer)
+        // Type function closures (type_manager::setTypeFunction) have it as a lightuserdata up value, so a resolved conversion path is applied without Lua calls (see ConversionPath)
+        class TypeFunction {
+        public:
+            using Function = void * (*)(const void *context, void *object);
+
+            Function function_;
+            const void *context_;
+            // the conversion is a constant pointer offset for a given userdata type
+            bool isConstantOffset_;
+
+            inline void * operator()(void *object) const;
+        };
+
+        // static_cast (D -> B)
+        template<typename D, typename B>
+        class StaticTypeFunction {
+        public:
+            static void * convert(const void *context, void *object);
+
+            inline static constexpr TypeFunction keTypeFunction{&convert, nullptr, true};
+        };
+
+        // userdata (UserDataWrapper<T> or compact T) -> T
+        // object is the (possibly misaligned) userdata block
+        template<typename T>
+        class UnderlyingTypeFunction {
+        public:
+            static void * convert(const void *context, void *object);
+
+            inline static constexpr TypeFunction keTypeFunction{&convert, nullptr, true};
+        };
+
+        // std::function (O -> C)
+        // it must not be moved: typeFunction_ context is this object
+        template<typename O, typename C>
+        class CustomTypeFunction {
+        public:
+            template<typename F>
+            inline CustomTypeFunction(F &&function);
+
+            // non-copyable
+            CustomTypeFunction(const CustomTypeFunction &) = delete;
+            CustomTypeFunction & operator=(const CustomTypeFunction &) = delete;
+
+            inline const TypeFunction & getTypeFunction() const;
+
+        private:
+            TypeFunction typeFunction_;
+            std::function<C *(O *)> function_;
+
+            static void * convert(const void *context, void *object);
+        };
+
+        //--
+
+        inline void * TypeFunction::operator()(void *object) const {
+            return function_(context_, object);
+        }
+
+        template<typename D, typename B>
+        void * StaticTypeFunction<D, B>::convert(const void *, void *object) {
+            return static_cast<void *>(static_cast<B *>(static_cast<D *>(object)));
+        }
+
+        template<typename T>
+        void * UnderlyingTypeFunction<T>::convert(const void *, void *object) {
+            return static_cast<void *>(static_cast<T *>(basic::getAlignedOffsetPointer<UserDataType<T>>(object)));
+        }
+
+        template<typename O, typename C>
+        template<typename F>
+        inline CustomTypeFunction<O, C>::CustomTypeFunction(F &&function) : typeFunction_{&convert, this, false}, function_(std::forward<F>(function)) {}
+
+        template<typename O, typename C>
+        inline const TypeFunction & CustomTypeFunction<O, C>::getTypeFunction() const {
+            return typeFunction_;
+        }
+
+        template<typename O, typename C>
+        void * CustomTypeFunction<O, C>::convert(const void *context, void *object) {
+            return static_cast<void *>(static_cast<const CustomTypeFunction *>(context)->function_(static_cast<O *>(object)));
+        }
+    }
+}
+
+#endif
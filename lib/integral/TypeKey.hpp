@@ -0,0 +1,53 @@
+//
+//  TypeKey.hpp
+//  integral
+//
+// MIT License
+//
+// Copyright (c) 2024 André Pereira Henriques (aphenriques (at) outlook (dot) com)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef integral_TypeKey_hpp
+#define integral_TypeKey_hpp
+
+namespace integral {
+    namespace detail {
+        // TypeKey<T>::get() is a unique address for each type T
+        // it is used as lightuserdata key in lua tables: lookups do not require string hashing
+        template<typename T>
+        class TypeKey {
+        public:
+            static constexpr void * get();
+
+        private:
+            // not const: prevents identical constants from being merged by the linker
+            inline static char key_ = 0;
+        };
+
+        //--
+
+        template<typename T>
+        constexpr void * TypeKey<T>::get() {
+            return &key_;
+        }
+    }
+}
+
+#endif
@@ -27,7 +27,9 @@
 #ifndef integral_UserDataWrapper_hpp
 #define integral_UserDataWrapper_hpp
 
+#include <type_traits>
 #include <utility>
+#include "CompactUserData.hpp"
 #include "UserDataWrapperBase.hpp"
 
 namespace integral {
@@ -41,6 +43,13 @@ namespace integral {
             inline ~UserDataWrapper() override;
         };
 
+        template<typename T>
+        constexpr bool keIsCompactUserData = CompactUserData<T>::value;
+
+        // object type stored in the userdata block. TypeKey<UserDataType<T>>::get() identifies the class metatable
+        template<typename T>
+        using UserDataType = std::conditional_t<keIsCompactUserData<T>, T, UserDataWrapper<T>>;
+
         //--
 
         template<typename T>
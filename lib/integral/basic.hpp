@@ -27,15 +27,29 @@
 #ifndef integral_basic_hpp
 #define integral_basic_hpp
 
+#include <cstddef>
+#include <cstdint>
 #include <string>
 #include <type_traits>
 #include <utility>
 #include <lua.hpp>
 #include "lua_compatibility.hpp"
+#include "TypeKey.hpp"
 
 namespace integral {
     namespace detail {
         namespace basic {
+            // userdata blocks are aligned to LUAI_MAXALIGN (lua 5.1 to 5.4 and luajit): objects with smaller alignment requirement need no padding
+            union LuaMaximumAlignment {
+                lua_Number number;
+                double floatingPoint;
+                void *pointer;
+                lua_Integer integer;
+                long longInteger;
+            };
+
+            constexpr std::size_t keUserDataAlignment = alignof(LuaMaximumAlignment);
+
             void setLuaFunction(lua_State *luaState, const char *name, lua_CFunction function, int nUpValues);
 
             inline void setLuaFunction(lua_State *luaState, const std::string &name, lua_CFunction function, int nUpValues);
@@ -46,16 +60,28 @@ namespace integral {
             template<typename T>
             T * getAlignedOffsetPointer(void *pointer);
 
+            // alignment is only known at runtime (alignment > 0)
+            inline void * getAlignedOffsetPointer(void *pointer, std::size_t alignment);
+
             // avoids constructor call on misaligned address (caught -fsanitize=undefined)
             template<typename T, typename ...A>
             inline void pushAlignedObject(lua_State *luaState, A &&...arguments);
 
+            // no uservalue (lua 5.4)
+            template<typename T, typename ...A>
+            inline void pushCompactAlignedObject(lua_State *luaState, A &&...arguments);
+
             template<typename T>
             T * getAlignedObjectPointer(lua_State *luaState, int index);
 
             template<typename T>
             T * getAlignedObjectPointer(lua_State *luaState, int index, const char *metatableName);
 
+            // REGISTRY[TypeKey<NamedClassMetatableKey<T>>::get()] = REGISTRY[name] (class metatable cache: lightuserdata lookup instead of string hashing)
+            template<typename T>
+            class NamedClassMetatableKey;
+
+            // the metatable is cached by type T: every call with the same T must use the same name
             template<typename T>
             bool pushClassMetatable(lua_State *luaState, const char *name);
 
@@ -73,12 +99,16 @@ namespace integral {
 
             template<typename T>
             constexpr auto getMaximumSizeToAlign() {
-                return sizeof(T) + alignof(T) - 1;
+                if constexpr (alignof(T) > keUserDataAlignment) {
+                    return sizeof(T) + alignof(T) - 1;
+                } else {
+                    return sizeof(T);
+                }
             }
 
             template<typename T>
             T * getAlignedOffsetPointer(void *pointer) {
-                if constexpr (alignof(T) > 1) {
+                if constexpr (alignof(T) > keUserDataAlignment) {
                     // attention! the reinterpret_cast might not be portable
                     const std::uintptr_t address = reinterpret_cast<std::uintptr_t>(pointer);
                     const std::uintptr_t offset = address % alignof(T);
@@ -89,6 +119,16 @@ namespace integral {
                 return static_cast<T *>(pointer);
             }
 
+            inline void * getAlignedOffsetPointer(void *pointer, std::size_t alignment) {
+                // attention! the reinterpret_cast might not be portable
+                const std::uintptr_t address = reinterpret_cast<std::uintptr_t>(pointer);
+                const std::uintptr_t offset = address % alignment;
+                if (offset != 0) {
+                    return reinterpret_cast<void *>(address + alignment - offset);
+                }
+                return pointer;
+            }
+
             template<typename T, typename ...A>
             inline void pushAlignedObject(lua_State *luaState, A &&...arguments) {
                 static_assert(std::is_pointer_v<T> == false, "unexpected pointer");
@@ -96,6 +136,13 @@ namespace integral {
                 new(getAlignedOffsetPointer<T>(userData)) T(std::forward<A>(arguments)...);
             }
 
+            template<typename T, typename ...A>
+            inline void pushCompactAlignedObject(lua_State *luaState, A &&...arguments) {
+                static_assert(std::is_pointer_v<T> == false, "unexpected pointer");
+                void * const userData = lua_compatibility::newuserdatauv(luaState, getMaximumSizeToAlign<T>(), 0);
+                new(getAlignedOffsetPointer<T>(userData)) T(std::forward<A>(arguments)...);
+            }
+
             template<typename T>
             T * getAlignedObjectPointer(lua_State *luaState, int index) {
                 static_assert(std::is_pointer_v<T> == false, "unexpected pointer");
@@ -120,7 +167,18 @@ namespace integral {
 
             template<typename T>
             bool pushClassMetatable(lua_State *luaState, const char *name) {
-                if (luaL_newmetatable(luaState, name) != 0) {
+                lua_compatibility::rawgetp(luaState, LUA_REGISTRYINDEX, TypeKey<NamedClassMetatableKey<T>>::get());
+                // stack: metatable (?)
+                if (lua_istable(luaState, -1) != 0) {
+                    // stack: metatable
+                    return false;
+                }
+                // stack: nil (?)
+                lua_pop(luaState, 1);
+                // stack:
+                const bool isNewMetatable = luaL_newmetatable(luaState, name) != 0;
+                // stack: metatable
+                if (isNewMetatable == true) {
                     // metatable.__index = metatable
                     lua_pushstring(luaState, "__index");
                     lua_pushvalue(luaState, -2); // duplicates the metatable
@@ -129,9 +187,12 @@ namespace integral {
                         getAlignedObjectPointer<T>(lambdaLuaState, 1)->~T();
                         return 0;
                     }, 0);
-                    return true;
                 }
-                return false;
+                lua_pushvalue(luaState, -1);
+                // stack: metatable | metatable
+                lua_compatibility::rawsetp(luaState, LUA_REGISTRYINDEX, TypeKey<NamedClassMetatableKey<T>>::get());
+                // stack: metatable
+                return isNewMetatable;
             }
 
             template<typename T>
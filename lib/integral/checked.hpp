@@ -0,0 +1,41 @@
+//
+//  checked.hpp
+//  integral
+//
+// MIT License
+//
+// Copyright (c) 2024 André Pereira Henriques (aphenriques (at) outlook (dot) com)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef integral_checked_hpp
+#define integral_checked_hpp
+
+// INTEGRAL_CHECKED is 1 if values created by integral itself (e.g.: the LuaFunctionWrapper upvalue of bound functions) are validated at runtime, and 0 otherwise
+// It is 0 if NDEBUG is defined (release builds), unless it is explicitly defined (-DINTEGRAL_CHECKED=1)
+// Attention! Every translation unit (including the library) should be compiled with the same INTEGRAL_CHECKED value
+#ifndef INTEGRAL_CHECKED
+#ifdef NDEBUG
+#define INTEGRAL_CHECKED 0
+#else
+#define INTEGRAL_CHECKED 1
+#endif
+#endif
+
+#endif
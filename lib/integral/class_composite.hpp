@@ -28,6 +28,7 @@
 #define integral_class_composite_hpp
 
 #include <functional>
+#include <string>
 #include <type_traits>
 #include <utility>
 #include <lua.hpp>
@@ -37,7 +38,9 @@
 #include "exchanger.hpp"
 #include "factory.hpp"
 #include "FunctionTraits.hpp"
+#include "property.hpp"
 #include "Setter.hpp"
+#include "StaticFunctionWrapper.hpp"
 #include "type_manager.hpp"
 
 namespace integral {
@@ -53,6 +56,9 @@ namespace integral {
             template<typename T, typename C, typename F>
             class SyntheticInheritanceComposite;
 
+            template<typename T, typename C, auto M>
+            class PropertyComposite;
+
             // T: class type
             // U: underlying type
             // curiously recurring template pattern (CRTP)
@@ -68,6 +74,9 @@ namespace integral {
                 template<typename K, typename F, typename ...E, std::size_t ...I>
                 inline decltype(auto) setFunction(K &&key, F &&function, DefaultArgument<E, I> &&...defaultArguments) &&;
 
+                template<auto F, typename K>
+                inline decltype(auto) setFunction(K &&key) &&;
+
                 template<typename K, typename F>
                 inline decltype(auto) setLuaFunction(K &&key, F &&luaFunction) &&;
 
@@ -80,6 +89,12 @@ namespace integral {
                 template<typename K, typename R, typename S>
                 inline decltype(auto) setSetter(K &&key, R S::* attribute) &&;
 
+                // M: data member pointer (e.g.: &Object::x_)
+                // property syntax in lua (object.x = object.x + 1) served by the class metatable __index and __newindex metamethods (see property.hpp)
+                // const data members are read-only
+                template<auto M>
+                inline PropertyComposite<T, U, M> setProperty(std::string name) &&;
+
                 // B: base class type
                 template<typename B>
                 inline InheritanceComposite<T, B, U> setBaseClass() &&;
@@ -87,6 +102,16 @@ namespace integral {
                 // F: type function
                 template<typename F>
                 inline SyntheticInheritanceComposite<T, U, F> setBaseClass(F &&typeFunction) &&;
+
+                // B: base class type
+                // base class methods are copied into the class metatable (see integral::defineFlattenedInheritance)
+                template<typename B>
+                inline InheritanceComposite<T, B, U> setFlattenedBaseClass() &&;
+
+                // F: type function
+                // base class methods are copied into the class metatable (see integral::defineFlattenedInheritance)
+                template<typename F>
+                inline SyntheticInheritanceComposite<T, U, F> setFlattenedBaseClass(F &&typeFunction) &&;
             };
 
             // T: Class type
@@ -125,12 +150,13 @@ namespace integral {
 
                 InheritanceComposite(InheritanceComposite &&) = default;
 
-                inline InheritanceComposite(C &&chainedClassMetatableComposite);
+                inline InheritanceComposite(C &&chainedClassMetatableComposite, bool isFlattened);
 
                 void push(lua_State *luaState) const;
 
             private:
                 C chainedClassMetatableComposite_;
+                bool isFlattened_;
             };
 
             // T: class type
@@ -145,13 +171,35 @@ namespace integral {
 
                 SyntheticInheritanceComposite(SyntheticInheritanceComposite &&) = default;
 
-                inline SyntheticInheritanceComposite(C &&chainedClassMetatableComposite, F &&typeFunction);
+                inline SyntheticInheritanceComposite(C &&chainedClassMetatableComposite, F &&typeFunction, bool isFlattened);
 
                 void push(lua_State *luaState) const;
 
             private:
                 C chainedClassMetatableComposite_;
                 F typeFunction_;
+                bool isFlattened_;
+            };
+
+            // T: class type
+            // M: data member pointer
+            template<typename T, typename C, auto M>
+            class PropertyComposite : public ClassCompositeInterface<T, PropertyComposite<T, C, M>> {
+                static_assert(std::is_reference_v<C> == false, "C cannot be a reference type");
+            public:
+                // non-copyable
+                PropertyComposite(const PropertyComposite &) = delete;
+                PropertyComposite & operator=(const PropertyComposite &) = delete;
+
+                PropertyComposite(PropertyComposite &&) = default;
+
+                inline PropertyComposite(C &&chainedClassMetatableComposite, std::string &&name);
+
+                void push(lua_State *luaState) const;
+
+            private:
+                C chainedClassMetatableComposite_;
+                std::string name_;
             };
         }
 
@@ -173,6 +221,12 @@ namespace integral {
             public:
                 inline static void push(lua_State *luaState, const class_composite::SyntheticInheritanceComposite<T, C, F> &composite);
             };
+
+            template<typename T, typename C, auto M>
+            class Exchanger<class_composite::PropertyComposite<T, C, M>> {
+            public:
+                inline static void push(lua_State *luaState, const class_composite::PropertyComposite<T, C, M> &composite);
+            };
         }
 
         //--
@@ -197,6 +251,12 @@ namespace integral {
                 return std::move(*this).set(std::forward<K>(key), factory::makeFunctionWrapper(std::forward<F>(function), std::move(defaultArguments)...));
             }
 
+            template<typename T, typename U>
+            template<auto F, typename K>
+            inline decltype(auto) ClassCompositeInterface<T, U>::setFunction(K &&key) && {
+                return std::move(*this).set(std::forward<K>(key), StaticFunctionWrapper<F>());
+            }
+
             template<typename T, typename U>
             template<typename K, typename F>
             inline decltype(auto) ClassCompositeInterface<T, U>::setLuaFunction(K &&key, F &&luaFunction) && {
@@ -221,10 +281,16 @@ namespace integral {
                 return std::move(*this).setFunction(std::forward<K>(key), Setter<S, R>(attribute));
             }
 
+            template<typename T, typename U>
+            template<auto M>
+            inline PropertyComposite<T, U, M> ClassCompositeInterface<T, U>::setProperty(std::string name) && {
+                return PropertyComposite<T, U, M>(std::move(*static_cast<U *>(this)), std::move(name));
+            }
+
             template<typename T, typename U>
             template<typename B>
             inline InheritanceComposite<T, B, U> ClassCompositeInterface<T, U>::setBaseClass() && {
-                return InheritanceComposite<T, B, U>(std::move(*static_cast<U *>(this)));
+                return InheritanceComposite<T, B, U>(std::move(*static_cast<U *>(this)), false);
             }
 
             template<typename T, typename U>
@@ -234,7 +300,23 @@ namespace integral {
                 using OriginalType = typename ConversionFunctionTraits::OriginalType;
                 // failing the following static_assert would NOT cause a bug. It exists to prevent an abstraction inconsistecy (it is a design choice)
                 static_assert(std::is_same_v<OriginalType, T> == true, "type function original type mismatch with metatable class type");
-                return SyntheticInheritanceComposite<T, U, F>(std::move(*static_cast<U *>(this)), std::forward<F>(typeFunction));
+                return SyntheticInheritanceComposite<T, U, F>(std::move(*static_cast<U *>(this)), std::forward<F>(typeFunction), false);
+            }
+
+            template<typename T, typename U>
+            template<typename B>
+            inline InheritanceComposite<T, B, U> ClassCompositeInterface<T, U>::setFlattenedBaseClass() && {
+                return InheritanceComposite<T, B, U>(std::move(*static_cast<U *>(this)), true);
+            }
+
+            template<typename T, typename U>
+            template<typename F>
+            inline SyntheticInheritanceComposite<T, U, F> ClassCompositeInterface<T, U>::setFlattenedBaseClass(F &&typeFunction) && {
+                using ConversionFunctionTraits = ConversionFunctionTraits<typename FunctionTraits<F>::Signature>;
+                using OriginalType = typename ConversionFunctionTraits::OriginalType;
+                // failing the following static_assert would NOT cause a bug. It exists to prevent an abstraction inconsistecy (it is a design choice)
+                static_assert(std::is_same_v<OriginalType, T> == true, "type function original type mismatch with metatable class type");
+                return SyntheticInheritanceComposite<T, U, F>(std::move(*static_cast<U *>(this)), std::forward<F>(typeFunction), true);
             }
 
             // ClassMetatableComposite
@@ -250,31 +332,51 @@ namespace integral {
                 // stack: table | key
                 exchanger::push<V>(luaState, value_);
                 // stack: table | key | value
-                lua_rawset(luaState, -3);
+                type_manager::rawsetWithFlattenedInheritance(luaState);
                 // stack: table 
             }
 
             // InheritanceComposite
             template<typename T, typename B, typename C>
-            inline InheritanceComposite<T, B, C>::InheritanceComposite(C &&chainedClassMetatableComposite) : chainedClassMetatableComposite_(std::forward<C>(chainedClassMetatableComposite)) {}
+            inline InheritanceComposite<T, B, C>::InheritanceComposite(C &&chainedClassMetatableComposite, bool isFlattened) : chainedClassMetatableComposite_(std::forward<C>(chainedClassMetatableComposite)), isFlattened_(isFlattened) {}
 
             template<typename T, typename B, typename C>
             void InheritanceComposite<T, B, C>::push(lua_State *luaState) const {
                 exchanger::push<C>(luaState, chainedClassMetatableComposite_);
                 // stack: table 
-                type_manager::defineInheritance<T, B>(luaState);
+                if (isFlattened_ == true) {
+                    type_manager::defineFlattenedInheritance<T, B>(luaState);
+                } else {
+                    type_manager::defineInheritance<T, B>(luaState);
+                }
                 // stack: table 
             }
 
             // SyntheticInheritanceComposite
             template<typename T, typename C, typename F>
-            inline SyntheticInheritanceComposite<T, C, F>::SyntheticInheritanceComposite(C &&chainedClassMetatableComposite, F &&typeFunction) : chainedClassMetatableComposite_(std::forward<C>(chainedClassMetatableComposite)), typeFunction_(std::forward<F>(typeFunction)) {}
+            inline SyntheticInheritanceComposite<T, C, F>::SyntheticInheritanceComposite(C &&chainedClassMetatableComposite, F &&typeFunction, bool isFlattened) : chainedClassMetatableComposite_(std::forward<C>(chainedClassMetatableComposite)), typeFunction_(std::forward<F>(typeFunction)), isFlattened_(isFlattened) {}
 
             template<typename T, typename C, typename F>
             void SyntheticInheritanceComposite<T, C, F>::push(lua_State *luaState) const {
                 exchanger::push<C>(luaState, chainedClassMetatableComposite_);
                 // stack: table
-                type_manager::defineInheritance(luaState, typeFunction_);
+                if (isFlattened_ == true) {
+                    type_manager::defineFlattenedInheritance(luaState, typeFunction_);
+                } else {
+                    type_manager::defineInheritance(luaState, typeFunction_);
+                }
+                // stack: table
+            }
+
+            // PropertyComposite
+            template<typename T, typename C, auto M>
+            inline PropertyComposite<T, C, M>::PropertyComposite(C &&chainedClassMetatableComposite, std::string &&name) : chainedClassMetatableComposite_(std::forward<C>(chainedClassMetatableComposite)), name_(std::move(name)) {}
+
+            template<typename T, typename C, auto M>
+            void PropertyComposite<T, C, M>::push(lua_State *luaState) const {
+                exchanger::push<C>(luaState, chainedClassMetatableComposite_);
+                // stack: table
+                property::setProperty<M>(luaState, name_);
                 // stack: table
             }
         }
@@ -294,6 +396,11 @@ namespace integral {
             inline void Exchanger<class_composite::SyntheticInheritanceComposite<T, C, F>>::push(lua_State *luaState, const class_composite::SyntheticInheritanceComposite<T, C, F> &composite) {
                 composite.push(luaState);
             }
+
+            template<typename T, typename C, auto M>
+            inline void Exchanger<class_composite::PropertyComposite<T, C, M>>::push(lua_State *luaState, const class_composite::PropertyComposite<T, C, M> &composite) {
+                composite.push(luaState);
+            }
         }
     }
 }
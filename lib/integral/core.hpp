@@ -30,6 +30,7 @@
 #include <cstddef>
 #include <functional>
 #include <string>
+#include <type_traits>
 #include <utility>
 #include <lua.hpp>
 #include "Caller.hpp"
@@ -44,10 +45,16 @@
 #include "factory.hpp"
 #include "FunctionWrapper.hpp"
 #include "FunctionTraits.hpp"
+#include "Key.hpp"
+#include "LuaFunction.hpp"
 #include "LuaFunctionArgument.hpp"
 #include "LuaFunctionWrapper.hpp"
 #include "LuaIgnoredArgument.hpp"
+#include "Overload.hpp"
+#include "property.hpp"
 #include "Setter.hpp"
+#include "StaticFunctionWrapper.hpp"
+#include "TableView.hpp"
 #include "type_manager.hpp"
 #include "UnexpectedStackException.hpp"
 
@@ -67,10 +74,37 @@ namespace integral {
     // It is meant to be used as an argument to a C++ function.
     // To call the function:
     // - R LuaFunctionArgument::call<R>(A ...&&);
-    // - 'R' is a non-reference value (it can be void).
+    // - 'R' is a non-reference value (it can be void or integral::Returns<T...> for multiple results).
     // The arguments are pushed by value onto the lua stack
+    // LuaFunctionArgument::callUnprotected<R>(A ...&&) propagates lua errors unchanged (no CallerException and no error message copy): the error value is raised again after the C++ frames of the bound function are unwound
     using LuaFunctionArgument = detail::LuaFunctionArgument;
 
+    // Typed handle to a (either C++ or lua) function kept in a lua registry slot.
+    // Unlike LuaFunctionArgument, it can be stored (it must not outlive the lua state). It is gotten with integral::get (or as a C++ function argument) and can be pushed.
+    // It is std::function compatible:
+    // - std::function<R(A...)> function = integral::get<integral::LuaFunction<R(A...)>>(luaState, index);
+    // - 'R' is a non-reference value (it can be void or integral::Returns<T...> for multiple results).
+    // The arguments are pushed by value onto the lua stack
+    template<typename F>
+    using LuaFunction = detail::LuaFunction<F>;
+
+    // Lua string interned once per lua state and name, and kept in a lua registry slot (keys with the same name share it; it is released when the state is closed).
+    // It can be used as a key wherever a string key is accepted (Reference::operator[], Table::set, ClassMetatable::set, ...): it is pushed with a single lua_rawgeti (no string hashing)
+    // - integral::Key key(luaState, "name");
+    // - luaState[key]; luaState["table"][key] = value;
+    using Key = detail::Key;
+
+    // Proxy to a table in lua state (no table copy: elements are converted on demand).
+    // The object of this class cannot be stored, it only points to a table in the stack.
+    // It is meant to be used as an argument to a C++ function (instead of std::vector or std::unordered_map).
+    // - std::size_t TableView<>::size(); // raw length
+    // - W TableView<>::get<W>(key); // raw access
+    // - for (auto entry : tableView) {entry.getKey<K>(); entry.getValue<V>();} // TableView<>
+    // - for (auto [key, value] : tableView) {...} // TableView<K, V>: std::pair<K, V>
+    // The iteration (lua_next) keeps the key and the value on the top of the stack: the stack must be balanced in each loop step
+    template<typename K = void, typename V = void>
+    using TableView = detail::TableView<K, V>;
+
     // Proxy to std::function<T>
     // It is used to push a function onto the lua stack
     // FunctionWrapper can not be gotten with integral::get
@@ -79,6 +113,19 @@ namespace integral {
     template<typename F, typename M = detail::DefaultArgumentManager<>>
     using FunctionWrapper = detail::FunctionWrapper<F, M>;
 
+    // Function (or member function) pointer bound at compile time
+    // It is pushed as a stateless lua_CFunction (no upvalues, no std::function and no heap allocation)
+    // StaticFunctionWrapper can not be gotten with integral::get
+    // "auto F": function pointer e.g &Object::getId
+    template<auto F>
+    using StaticFunctionWrapper = detail::StaticFunctionWrapper<F>;
+
+    // Set of functions bound as a single Lua function. The function is chosen by the number and the Lua types of the arguments (see detail::Overload)
+    // Overload can not be gotten with integral::get
+    // "typename ...F": function pointer, member function pointer or functor types
+    template<typename ...F>
+    using Overload = detail::Overload<F...>;
+
     // Proxy to class contructor
     // It is used to push a constructor onto the lua stack
     // ConstructorWrapper can not be gotten with integral::get
@@ -94,6 +141,11 @@ namespace integral {
     template<typename F, typename ...E, std::size_t ...I>
     inline decltype(auto) makeFunctionWrapper(F &&function, DefaultArgument<E, I> &&...defaultArguments);
 
+    // Makes an Overload object
+    // "functions...": functions to be overloaded. Functions without object (userdata) arguments are tried first, then functions with object arguments (type manager check), each group in declaration order
+    template<typename ...F>
+    inline Overload<std::decay_t<F>...> overload(F &&...functions);
+
     // Makes a ConstructorWrapper object
     // "typename F": function type e.g T(A...) (it is an abstraction. The constructor is not a function)
     // "defaultArguments...": pack of default arguments. Each with its own specific type E at index I (every type is deduced from the function arguments). DefaultArgument Index I starts with 1 (like lua). Static checking is performed, so the invalid type or/and index causes compilation error.
@@ -150,6 +202,16 @@ namespace integral {
     template<typename F>
     inline void defineInheritance(lua_State *luaState, F &&typeFunction);
 
+    // Same as defineInheritance<D, B>, but base class B methods are also copied into D class metatable, so that method lookups do not go through the __index metamethod chain.
+    // Fields set later in B class metatable (or in its own bases) are propagated to D class metatable. Fields defined in D class metatable are never overwritten.
+    // the __newindex metamethod of B class metatable metatable is set (preserving other metamethods)
+    template<typename D, typename B>
+    inline void defineFlattenedInheritance(lua_State *luaState);
+
+    // Same as defineInheritance(luaState, typeFunction), but the methods of the converted type class are also copied into T class metatable (see defineFlattenedInheritance<D, B>).
+    template<typename F>
+    inline void defineFlattenedInheritance(lua_State *luaState, F &&typeFunction);
+
     // Pushes a type "T" value (string or number) or object onto the stack.
     // References and pointers (except const char *) can not be pushed.
     // The class metatable is automatically registered if needed.
@@ -207,6 +269,16 @@ namespace integral {
     template<typename F, typename ...E, std::size_t ...I>
     inline void pushFunction(lua_State *luaState, F &&function, DefaultArgument<E, I> &&...defaultArguments);
 
+    // Binds a function pointer or member function pointer "F" (template argument) in the table or metatable on top of the stack.
+    // The bound lua_CFunction is stateless: no upvalues, no std::function and no heap allocation. Default arguments are not supported.
+    // The function is managed by integral so that if an exception is thrown from it, it is translated to a Lua error
+    // "name": name of the bound Lua function.
+    template<auto F>
+    void setFunction(lua_State *luaState, const std::string &name);
+
+    template<auto F>
+    inline void pushFunction(lua_State *luaState);
+
     // Binds a getter function in the table or metatable on top of the stack.
     // The function returns by value (_not_ by reference)
     // "name": name of the bound Lua function.
@@ -226,11 +298,20 @@ namespace integral {
     template<typename R, typename T>
     inline void pushSetter(lua_State *luaState, R T::* attribute);
 
+    // Sets a property in the class metatable on top of the stack.
+    // Lua code accesses it with field syntax (object.name and object.name = value) through the class metatable __index and __newindex metamethods. Other names are looked up as methods.
+    // Properties are not inherited by derived class metatables.
+    // "M": data member pointer (e.g.: &Object::x_). const data members are read-only
+    // "name": name of the property.
+    template<auto M>
+    inline void setProperty(lua_State *luaState, const std::string &name);
+
     // Calls function on top of the stack
     // "arguments" are pushed by value.
     // "R" is the return type, returned as follows (such as integral::get):
     // - objects (except std::vector, std::array, std::unordered_map, std::tuple and std::string) are returned by reference
     // - lua types (number, table and strings) are returned by value.
+    // - integral::Returns<T...> gets sizeof...(T) results from the stack (not from a table). Its elements are stored by value.
     // The function is popped from stack
     // Throws a CallerException exception on error.
     // It is not necessary to explicitly specify argument template types.
@@ -244,6 +325,11 @@ namespace integral {
         return detail::factory::makeFunctionWrapper(std::forward<F>(function), std::move(defaultArguments)...);
     }
 
+    template<typename ...F>
+    inline Overload<std::decay_t<F>...> overload(F &&...functions) {
+        return Overload<std::decay_t<F>...>(std::forward<F>(functions)...);
+    }
+
     template<typename F, typename ...E, std::size_t ...I>
     inline decltype(auto) makeConstructorWrapper(DefaultArgument<E, I> &&...defaultArguments) {
         return detail::factory::makeConstructorWrapper<F>(std::move(defaultArguments)...);
@@ -274,6 +360,16 @@ namespace integral {
         detail::type_manager::defineInheritance(luaState, std::forward<F>(typeFunction));
     }
 
+    template<typename D, typename B>
+    inline void defineFlattenedInheritance(lua_State *luaState) {
+        detail::type_manager::defineFlattenedInheritance<D, B>(luaState);
+    }
+
+    template<typename F>
+    inline void defineFlattenedInheritance(lua_State *luaState, F &&typeFunction) {
+        detail::type_manager::defineFlattenedInheritance(luaState, std::forward<F>(typeFunction));
+    }
+
     template<typename T, typename ...A>
     inline void push(lua_State *luaState, A &&...arguments) {
         detail::exchanger::push<T>(luaState, std::forward<A>(arguments)...);
@@ -295,7 +391,7 @@ namespace integral {
             pushConstructor<F>(luaState, std::move(defaultArguments)...);
             lua_pushstring(luaState, name.c_str());
             lua_insert(luaState, -2);
-            lua_rawset(luaState, -3);
+            detail::type_manager::rawset(luaState);
         } else {
             throw UnexpectedStackException(luaState, __FILE__, __LINE__, __func__, "missing table to set constructor");
         }
@@ -312,7 +408,7 @@ namespace integral {
             pushLuaFunction(luaState, std::forward<F>(luaFunction), nUpValues);
             lua_pushstring(luaState, name.c_str());
             lua_insert(luaState, -2);
-            lua_rawset(luaState, -3);
+            detail::type_manager::rawset(luaState);
         } else {
             throw UnexpectedStackException(luaState, __FILE__, __LINE__, __func__, "missing table to set lua function");
         }
@@ -330,7 +426,7 @@ namespace integral {
             pushFunction(luaState, std::forward<F>(function), std::move(defaultArguments)...);
             lua_pushstring(luaState, name.c_str());
             lua_insert(luaState, -2);
-            lua_rawset(luaState, -3);
+            detail::type_manager::rawset(luaState);
         } else {
             throw UnexpectedStackException(luaState, __FILE__, __LINE__, __func__, "missing table to set function");
         }
@@ -341,6 +437,23 @@ namespace integral {
         push<FunctionWrapper<typename detail::FunctionTraits<F>::Signature, detail::DefaultArgumentManager<DefaultArgument<E, I>...>>>(luaState, FunctionWrapper<typename detail::FunctionTraits<F>::Signature, detail::DefaultArgumentManager<DefaultArgument<E, I>...>>(std::forward<F>(function), std::move(defaultArguments)...));
     }
 
+    template<auto F>
+    void setFunction(lua_State *luaState, const std::string &name) {
+        if (lua_istable(luaState, -1) != 0) {
+            pushFunction<F>(luaState);
+            lua_pushstring(luaState, name.c_str());
+            lua_insert(luaState, -2);
+            detail::type_manager::rawset(luaState);
+        } else {
+            throw UnexpectedStackException(luaState, __FILE__, __LINE__, __func__, "missing table to set function");
+        }
+    }
+
+    template<auto F>
+    inline void pushFunction(lua_State *luaState) {
+        push<StaticFunctionWrapper<F>>(luaState);
+    }
+
     template<typename R, typename T>
     inline void setGetter(lua_State *luaState, const std::string &name, R T::* attribute) {
         setFunction(luaState, name, detail::Getter<T, R>(attribute));
@@ -361,6 +474,11 @@ namespace integral {
         pushFunction(luaState, detail::Setter<T, R>(attribute));
     }
 
+    template<auto M>
+    inline void setProperty(lua_State *luaState, const std::string &name) {
+        detail::property::setProperty<M>(luaState, name);
+    }
+
     template<typename R, typename ...A>
     inline decltype(auto) call(lua_State *luaState, A &&...arguments) {
         return detail::Caller<R, A...>::call(luaState, std::forward<A>(arguments)...);
@@ -102,7 +102,7 @@ namespace integral {
                 }
             }
 
-            std::string Exchanger<LuaFunctionWrapper>::getCurrentSourceAndLine(lua_State *luaState) {
+            std::string getCurrentSourceAndLine(lua_State *luaState) {
                 lua_Debug debugInfo;
                 if (lua_getstack(luaState, 1, &debugInfo) != 0) {
                     lua_getinfo(luaState, "S", &debugInfo);
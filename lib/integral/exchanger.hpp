@@ -38,7 +38,6 @@
 #include <string_view>
 #include <tuple>
 #include <type_traits>
-#include <typeinfo>
 #include <unordered_map>
 #include <utility>
 #include <vector>
@@ -46,10 +45,16 @@
 #include <exception/Exception.hpp>
 #include "ArgumentException.hpp"
 #include "basic.hpp"
+#include "checked.hpp"
 #include "generic.hpp"
+#include "InlineCache.hpp"
 #include "lua_compatibility.hpp"
+#include "LuaError.hpp"
 #include "LuaFunctionWrapper.hpp"
+#include "Returns.hpp"
+#include "rtti.hpp"
 #include "type_manager.hpp"
+#include "TypeKey.hpp"
 #include "UnexpectedStackException.hpp"
 #include "UserDataWrapper.hpp"
 #include "UserDataWrapperBase.hpp"
@@ -59,9 +64,30 @@ namespace integral {
         namespace exchanger {
             extern const char * const gkAutomaticInheritanceKey;
 
+            // thread_local InlineCache per type T (lua_States are independent between threads)
+            template<typename T>
+            inline InlineCache & getInlineCache();
+
+            // InlineCache lookup only: returns nullptr on a cache miss (it does not throw)
+            template<typename T>
+            T * findObject(lua_State *luaState, int index);
+
+            // non-throwing conversion test: returns true if getObject<T> succeeds (same lookup order)
+            template<typename T>
+            bool isObject(lua_State *luaState, int index);
+
+            // uses a thread_local InlineCache per type T
             template<typename T>
             T & getObject(lua_State *luaState, int index);
 
+            // does not look up inlineCache, but fills it when the conversion is a constant offset (inlineCache may be nullptr)
+            template<typename T>
+            T & resolveObject(lua_State *luaState, int index, InlineCache *inlineCache);
+
+            // pushes UserDataWrapper<T> or compact T (CompactUserData<T>) without metatable
+            template<typename T, typename ...A>
+            inline void pushUserData(lua_State *luaState, A &&...arguments);
+
             template<typename T, typename ...A>
             void pushObject(lua_State *luaState, A &&...arguments);
 
@@ -215,11 +241,10 @@ namespace integral {
                 template<typename F, typename ...A>
                 inline static void pushWithTypeFunction(lua_State *luaState, const F &typeFunction, A &&...arguments);
 
-            private:
                 // setInheritanceFunction:
                 // signature: void(lua_State *)
                 // stack argument: metatable
-                // sets inheritance as type_manager::setInheritance
+                // sets inheritance as type_manager::setInheritance (and any other metatable field) when the metatable is first used
                 template<typename S, typename ...A>
                 inline static void pushGeneric(lua_State *luaState, const S &setInheritanceFunction, A &&...arguments);
             };
@@ -246,10 +271,15 @@ namespace integral {
 
             private:
                 static const char * const kMetatableName_;
-
-                static std::string getCurrentSourceAndLine(lua_State *luaState);
             };
 
+            std::string getCurrentSourceAndLine(lua_State *luaState);
+
+            // calls a lua_CFunction like function or functor
+            // exceptions thrown by it are translated to a Lua error (lua_error does not return)
+            template<typename F>
+            int callLuaFunction(lua_State *luaState, const F &luaFunction);
+
             template<typename T>
             using ExchangerType = Exchanger<std::decay_t<T>>;
 
@@ -267,24 +297,122 @@ namespace integral {
             template<typename A, typename ...B>
             void pushCopy(lua_State *luaState, A &&firstArgument, B &&...remainingArguments);
 
+            // pushes the return value of a bound function (of type R) and returns the number of pushed values
+            // Returns<T...> elements are pushed as separate values; any other type is pushed as a single value (push<R>)
+            template<typename R, typename V>
+            inline int pushReturnValue(lua_State *luaState, V &&value);
+
+            // std::vector and std::array elements of arithmetic types (except bool) are converted with direct lua_tonumberx/lua_tointegerx calls (no exchanger dispatch and no exception handling per element)
+            template<typename T>
+            constexpr bool keIsNumericElement = std::is_arithmetic_v<T> == true && std::is_same_v<T, bool> == false;
+
+            // stack: table
+            // gets the table elements [1, size] into "elements". Values that are not numbers (e.g. convertible userdata) are gotten with exchanger::get
+            // "index": stack index of the table argument (used in the exception message)
+            // throws ArgumentException (prefixed with "errorMessagePrefix") and pops the table if an element is invalid
+            template<typename T>
+            void getNumericElements(lua_State *luaState, int index, T *elements, std::size_t size, const char *errorMessagePrefix);
+
+            template<typename R>
+            class ReturnValue {
+            public:
+                template<typename V>
+                inline static int push(lua_State *luaState, V &&value);
+            };
+
+            template<typename ...T>
+            class ReturnValue<Returns<T...>> {
+            public:
+                template<typename V>
+                inline static int push(lua_State *luaState, V &&value);
+
+            private:
+                template<typename V, std::size_t ...S>
+                inline static void push(lua_State *luaState, V &&value, std::index_sequence<S...>);
+            };
+
             //--
 
-            // dynamic_cast is faster then getConvertibleType, but getConvertibleType provides the expected behaviour with synthetic inheritance
+            template<typename T>
+            inline InlineCache & getInlineCache() {
+                // lua_States are independent between threads
+                static thread_local InlineCache inlineCache;
+                return inlineCache;
+            }
+
+            template<typename T>
+            T * findObject(lua_State *luaState, int index) {
+                void * const userData = lua_touserdata(luaState, index);
+                if (userData != nullptr && lua_getmetatable(luaState, index) != 0) {
+                    // stack: metatable
+                    const void * const metatable = lua_topointer(luaState, -1);
+                    lua_pop(luaState, 1);
+                    // stack:
+                    return static_cast<T *>(getInlineCache<T>().find(userData, metatable));
+                }
+                return nullptr;
+            }
+
+            template<typename T>
+            bool isObject(lua_State *luaState, int index) {
+                if (findObject<T>(luaState, index) != nullptr) {
+                    return true;
+                }
+                if (lua_isuserdata(luaState, index) == 0) {
+                    return false;
+                }
+                if (type_manager::getUserDataWrapper<T>(luaState, index) != nullptr || type_manager::getConvertibleType<T>(luaState, index) != nullptr) {
+                    return true;
+                }
+#if INTEGRAL_WITH_RTTI
+                UserDataWrapperBase *userDataWrapperBase = type_manager::getUserDataWrapperBase(luaState, index);
+                return userDataWrapperBase != nullptr && dynamic_cast<T *>(userDataWrapperBase) != nullptr;
+#else
+                return false;
+#endif
+            }
+
             template<typename T>
             T & getObject(lua_State *luaState, int index) {
+                T * const object = findObject<T>(luaState, index);
+                if (object != nullptr) {
+                    return *object;
+                }
+                return resolveObject<T>(luaState, index, &getInlineCache<T>());
+            }
+
+            // dynamic_cast is faster then getConvertibleType, but getConvertibleType provides the expected behaviour with synthetic inheritance
+            // dynamic_cast is only used for relationships unknown to the type manager (and its result is memoized)
+            template<typename T>
+            T & resolveObject(lua_State *luaState, int index, InlineCache *inlineCache) {
                 if (lua_isuserdata(luaState, index) != 0) {
-                    UserDataWrapper<T> *userDataWrapper = type_manager::getUserDataWrapper<T>(luaState, index);
+                    UserDataType<T> *userDataWrapper = type_manager::getUserDataWrapper<T>(luaState, index);
                     if (userDataWrapper != nullptr) {
-                        return *static_cast<T *>(userDataWrapper);
+                        T * const object = static_cast<T *>(userDataWrapper);
+                        if (inlineCache != nullptr) {
+                            inlineCache->insert(luaState, index, object);
+                        }
+                        return *object;
                     } else {
-                        T *object = type_manager::getConvertibleType<T>(luaState, index);
+                        bool isConstantOffset;
+                        T *object = type_manager::getConvertibleType<T>(luaState, index, isConstantOffset);
                         if (object != nullptr) {
+                            if (inlineCache != nullptr && isConstantOffset == true) {
+                                inlineCache->insert(luaState, index, object);
+                            }
                             return *object;
                         } else {
+#if INTEGRAL_WITH_RTTI
                             UserDataWrapperBase *userDataWrapperBase = type_manager::getUserDataWrapperBase(luaState, index);
                             if (userDataWrapperBase != nullptr) {
                                 T *castenObject = dynamic_cast<T *>(userDataWrapperBase);
                                 if (castenObject != nullptr) {
+                                    // the dynamic type of the userdata is fixed by its metatable: the offset is constant
+                                    // it is memoized in the conversion path cache: the next getConvertibleType call does not need dynamic_cast
+                                    type_manager::setConstantOffsetConversionPath(luaState, index, TypeKey<T>::get(), castenObject);
+                                    if (inlineCache != nullptr) {
+                                        inlineCache->insert(luaState, index, castenObject);
+                                    }
                                     return *castenObject;
                                 } else {
                                     throw ArgumentException(luaState, index, "invalid dynamic_cast - incompatible userdata type or ambiguous cast");
@@ -292,6 +420,9 @@ namespace integral {
                             } else {
                                 throw ArgumentException(luaState, index, "unknown userdata type or incompatible UserDataWrapperBase objects");
                             }
+#else
+                            throw ArgumentException(luaState, index, "unknown userdata type or undefined inheritance (dynamic_cast requires RTTI)");
+#endif
                         }
                     }
                 } else {
@@ -299,9 +430,18 @@ namespace integral {
                 }
             }
 
+            template<typename T, typename ...A>
+            inline void pushUserData(lua_State *luaState, A &&...arguments) {
+                if constexpr (keIsCompactUserData<T> == true) {
+                    basic::pushCompactAlignedObject<T>(luaState, std::forward<A>(arguments)...);
+                } else {
+                    basic::pushAlignedObject<UserDataWrapper<T>>(luaState, std::forward<A>(arguments)...);
+                }
+            }
+
             template<typename T, typename ...A>
             void pushObject(lua_State *luaState, A &&...arguments) {
-                basic::pushAlignedObject<UserDataWrapper<T>>(luaState, std::forward<A>(arguments)...);
+                pushUserData<T>(luaState, std::forward<A>(arguments)...);
                 // stack: userdata_no_metatable
                 type_manager::pushClassMetatable<T>(luaState); // type_manager will automatically register unknown types
                 // stack: userdata_no_metatable | metatable
@@ -447,6 +587,35 @@ namespace integral {
                 lua_pushnumber(luaState, static_cast<lua_Number>(number));
             }
 
+            template<typename T>
+            void getNumericElements(lua_State *luaState, int index, T *elements, std::size_t size, const char *errorMessagePrefix) {
+                for (std::size_t i = 0; i < size; ++i) {
+                    // stack: table
+                    lua_compatibility::rawgeti(luaState, -1, static_cast<lua_Integer>(i + 1));
+                    // stack: table | element (?)
+                    int isNumber;
+                    if constexpr (std::is_floating_point_v<T> == true) {
+                        elements[i] = static_cast<T>(lua_compatibility::tonumberx(luaState, -1, &isNumber));
+                    } else if constexpr (std::is_signed_v<T> == true) {
+                        elements[i] = static_cast<T>(lua_compatibility::tointegerx(luaState, -1, &isNumber));
+                    } else {
+                        elements[i] = static_cast<T>(lua_compatibility::tounsignedx(luaState, -1, &isNumber));
+                    }
+                    if (isNumber == 0) {
+                        try {
+                            elements[i] = exchanger::get<T>(luaState, -1);
+                        } catch (const ArgumentException &argumentException) {
+                            // stack: table | ?
+                            lua_pop(luaState, 2);
+                            throw ArgumentException(luaState, index, errorMessagePrefix, argumentException);
+                        }
+                    }
+                    // stack: table | element
+                    lua_pop(luaState, 1);
+                    // stack: table
+                }
+            }
+
             template<typename T>
             std::vector<T> Exchanger<std::vector<T>>::get(lua_State *luaState, int index) {
                 if (lua_isuserdata(luaState, index) == 0) {
@@ -454,28 +623,35 @@ namespace integral {
                         lua_pushvalue(luaState, index);
                         // stack: table
                         const std::size_t tableSize = static_cast<std::size_t>(lua_compatibility::rawlen(luaState, -1));
-                        std::vector<T> returnVector;
-                        returnVector.reserve(tableSize);
-                        for (std::size_t i = 1; i <= tableSize; ++i) {
+                        if constexpr (keIsNumericElement<T> == true) {
+                            // presized: elements are written in place
+                            std::vector<T> returnVector(tableSize);
+                            getNumericElements(luaState, index, returnVector.data(), tableSize, "invalid table - std::vector - element: ");
                             // stack: table
-                            lua_compatibility::pushunsigned(luaState, i);
-                            // stack: table | i
-                            lua_rawget(luaState, -2);
-                            // stack: table | luaVectorElement (?)
-                            try {
-                                returnVector.push_back(exchanger::get<T>(luaState, -1));
-                            } catch (const ArgumentException &argumentException) {
-                                // stack: table | ?
-                                lua_pop(luaState, 2);
-                                throw ArgumentException(luaState, index, std::string("invalid table - std::vector - element: " ) + argumentException.what());
-                            }
-                            // stack: table | luaVectorElement
                             lua_pop(luaState, 1);
+                            return returnVector;
+                        } else {
+                            std::vector<T> returnVector;
+                            returnVector.reserve(tableSize);
+                            for (std::size_t i = 1; i <= tableSize; ++i) {
+                                // stack: table
+                                lua_compatibility::rawgeti(luaState, -1, static_cast<lua_Integer>(i));
+                                // stack: table | luaVectorElement (?)
+                                try {
+                                    returnVector.push_back(exchanger::get<T>(luaState, -1));
+                                } catch (const ArgumentException &argumentException) {
+                                    // stack: table | ?
+                                    lua_pop(luaState, 2);
+                                    throw ArgumentException(luaState, index, "invalid table - std::vector - element: ", argumentException);
+                                }
+                                // stack: table | luaVectorElement
+                                lua_pop(luaState, 1);
+                                // stack: table
+                            }
                             // stack: table
+                            lua_pop(luaState, 1);
+                            return returnVector;
                         }
-                        // stack: table
-                        lua_pop(luaState, 1);
-                        return returnVector;
                     } else {
                         throw ArgumentException::createTypeErrorException(luaState, index, lua_typename(luaState, LUA_TTABLE));
                     }
@@ -498,11 +674,9 @@ namespace integral {
                     // stack: table
                     for (SizeType i = 0; i < vectorSize; ++i) {
                         // stack: table
-                        lua_compatibility::pushunsigned(luaState, i + 1);
-                        // stack: table | i
-                        exchanger::push<T>(luaState, vector.at(i));
-                        // stack: table | i | luaVectorElement
-                        lua_rawset(luaState, -3);
+                        exchanger::push<T>(luaState, vector[i]);
+                        // stack: table | luaVectorElement
+                        lua_compatibility::rawseti(luaState, -2, static_cast<lua_Integer>(i + 1));
                         // stack: table
                     }
                 } else {
@@ -519,26 +693,31 @@ namespace integral {
                         const auto tableSize = lua_compatibility::rawlen(luaState, -1);
                         if (tableSize == N) {
                             std::array<T, N> returnArray;
-                            for (std::size_t i = 1; i <= tableSize; ++i) {
+                            if constexpr (keIsNumericElement<T> == true) {
+                                getNumericElements(luaState, index, returnArray.data(), N, "invalid table - std::array - element: ");
                                 // stack: table
-                                lua_compatibility::pushunsigned(luaState, i);
-                                // stack: table | i
-                                lua_rawget(luaState, -2);
-                                // stack: table | luaArrayElement (?)
-                                try {
-                                    returnArray.at(i - 1) = exchanger::get<T>(luaState, -1);
-                                } catch (const ArgumentException &argumentException) {
-                                    // stack: table | ?
-                                    lua_pop(luaState, 2);
-                                    throw ArgumentException(luaState, index, std::string("invalid table - std::array - element: " ) + argumentException.what());
-                                }
-                                // stack: table | luaArrayElement
                                 lua_pop(luaState, 1);
+                                return returnArray;
+                            } else {
+                                for (std::size_t i = 1; i <= N; ++i) {
+                                    // stack: table
+                                    lua_compatibility::rawgeti(luaState, -1, static_cast<lua_Integer>(i));
+                                    // stack: table | luaArrayElement (?)
+                                    try {
+                                        returnArray[i - 1] = exchanger::get<T>(luaState, -1);
+                                    } catch (const ArgumentException &argumentException) {
+                                        // stack: table | ?
+                                        lua_pop(luaState, 2);
+                                        throw ArgumentException(luaState, index, "invalid table - std::array - element: ", argumentException);
+                                    }
+                                    // stack: table | luaArrayElement
+                                    lua_pop(luaState, 1);
+                                    // stack: table
+                                }
                                 // stack: table
+                                lua_pop(luaState, 1);
+                                return returnArray;
                             }
-                            // stack: table
-                            lua_pop(luaState, 1);
-                            return returnArray;
                         } else {
                             std::ostringstream errorMessage;
                             errorMessage << "wrong table - std::array - size: expected " << N << ", got " << tableSize;
@@ -564,11 +743,9 @@ namespace integral {
                     // stack: table
                     for (std::size_t i = 0; i < N; ++i) {
                         // stack: table
-                        lua_compatibility::pushunsigned(luaState, i + 1);
-                        // stack: table | i
-                        exchanger::push<T>(luaState, array.at(i));
-                        // stack: table | i | luaArrayElement
-                        lua_rawset(luaState, -3);
+                        exchanger::push<T>(luaState, array[i]);
+                        // stack: table | luaArrayElement
+                        lua_compatibility::rawseti(luaState, -2, static_cast<lua_Integer>(i + 1));
                         // stack: table
                     }
                 } else {
@@ -595,7 +772,7 @@ namespace integral {
                             } catch (const ArgumentException &argumentException) {
                                 // stack: table | ? | ? | ?
                                 lua_pop(luaState, 4);
-                                throw ArgumentException(luaState, index, std::string("invalid table - std::unordered_map: " ) + argumentException.what());
+                                throw ArgumentException(luaState, index, "invalid table - std::unordered_map: ", argumentException);
                             }
                         }
                         // stack: table
@@ -680,7 +857,7 @@ namespace integral {
                             try {
                                 return std::tuple<T...>(getElementFromTable<S + 1, T>(luaState, index)...);
                             } catch (const ArgumentException &argumentException) {
-                                throw ArgumentException(luaState, index, std::string("invalid table - std::tuple: " ) + argumentException.what());
+                                throw ArgumentException(luaState, index, "invalid table - std::tuple: ", argumentException);
                             }
                         } else {
                             std::ostringstream errorMessage;
@@ -809,7 +986,7 @@ namespace integral {
             template<typename D>
             template<typename S, typename ...A>
             void AutomaticInheritanceBase<D>::pushGeneric(lua_State *luaState, const S &setInheritanceFunction, A &&...arguments) {
-                basic::pushAlignedObject<UserDataWrapper<D>>(luaState, std::forward<A>(arguments)...);
+                pushUserData<D>(luaState, std::forward<A>(arguments)...);
                 // stack: userdata_no_metatable
                 type_manager::pushClassMetatable<D>(luaState); // type_manager will automatically register unknown types
                 // stack: userdata_no_metatable | metatable
@@ -877,30 +1054,22 @@ namespace integral {
                     }
                     // stack: userdata | upValues...
                     lua_pushcclosure(luaState, [](lua_State *lambdaLuaState) -> int {
-                        try {
+                        return callLuaFunction(lambdaLuaState, [](lua_State *callLuaState) -> int {
+#if INTEGRAL_CHECKED
                             const LuaFunctionWrapper *luaFunctionWrapper = basic::getAlignedObjectPointer<LuaFunctionWrapper>(
-                                lambdaLuaState,
+                                callLuaState,
                                 lua_upvalueindex(1),
                                 kMetatableName_
                             );
-                            if (luaFunctionWrapper != nullptr) {
-                                return luaFunctionWrapper->getLuaFunction()(lambdaLuaState);
-                            } else {
+                            if (luaFunctionWrapper == nullptr) {
                                 throw exception::LogicException(__FILE__, __LINE__, __func__, "corrupted LuaFunctionWrapper");
                             }
-                        } catch (const std::exception &exception) {
-                            lua_pushstring(
-                                lambdaLuaState,
-                                ("[integral] " + getCurrentSourceAndLine(lambdaLuaState) + ' ' + exception.what()).c_str()
-                            );
-                        } catch (...) {
-                            lua_pushstring(
-                                lambdaLuaState,
-                                ("[integral] " + getCurrentSourceAndLine(lambdaLuaState) + " unknown exception thrown").c_str()
-                            );
-                        }
-                        // error return outside catch scope so that the exception destructor can be called
-                        return lua_error(lambdaLuaState);
+#else
+                            // the upvalue is created by integral: its metatable is not checked (no registry lookup)
+                            const LuaFunctionWrapper *luaFunctionWrapper = basic::getAlignedObjectPointer<LuaFunctionWrapper>(callLuaState, lua_upvalueindex(1));
+#endif
+                            return luaFunctionWrapper->getLuaFunction()(callLuaState);
+                        });
                     }, 1 + nUpValues);
                     // stack: function
                 } else {
@@ -908,6 +1077,38 @@ namespace integral {
                 }
             }
 
+            template<typename F>
+            int callLuaFunction(lua_State *luaState, const F &luaFunction) {
+                try {
+                    return luaFunction(luaState);
+                } catch (const LuaError &luaError) {
+                    // Caller::callUnprotected: the error value is raised unchanged
+                    if (luaError.getErrorIndex() <= lua_gettop(luaState)) {
+                        lua_pushvalue(luaState, luaError.getErrorIndex());
+                    } else {
+                        lua_pushstring(luaState, ("[integral] " + getCurrentSourceAndLine(luaState) + " lua error value removed from the stack").c_str());
+                    }
+                } catch (const ArgumentException &argumentException) {
+                    // the frame of the lua function that threw the exception is live: the message includes its name
+                    lua_pushstring(
+                        luaState,
+                        ("[integral] " + getCurrentSourceAndLine(luaState) + ' ' + argumentException.getMessage(luaState)).c_str()
+                    );
+                } catch (const std::exception &exception) {
+                    lua_pushstring(
+                        luaState,
+                        ("[integral] " + getCurrentSourceAndLine(luaState) + ' ' + exception.what()).c_str()
+                    );
+                } catch (...) {
+                    lua_pushstring(
+                        luaState,
+                        ("[integral] " + getCurrentSourceAndLine(luaState) + " unknown exception thrown").c_str()
+                    );
+                }
+                // error return outside catch scope so that the exception destructor can be called
+                return lua_error(luaState);
+            }
+
             template<typename T>
             inline decltype(auto) get(lua_State *luaState, int index) {
                 return ExchangerType<T>::get(luaState, index);
@@ -923,7 +1124,7 @@ namespace integral {
                     // stack: ?...
                     const int stackIndexDelta = lua_gettop(luaState) - stackTopIndex;
                     if (stackIndexDelta != 1) {
-                        throw UnexpectedStackException(luaState, __FILE__, __LINE__, __func__, stackIndexDelta, " elements pushed onto the stack (expected 1 element) with exchanger::push (type: '", typeid(T).name(), "')");
+                        throw UnexpectedStackException(luaState, __FILE__, __LINE__, __func__, stackIndexDelta, " elements pushed onto the stack (expected 1 element) with exchanger::push (type: '", rtti::getTypeName<T>(), "')");
                     }
                 } else {
                     // LuaFunctionWrapper has a different logic to check the stack because of upvalues (see Exchanger<LuaFunctionWrapper>::push)
@@ -938,6 +1139,33 @@ namespace integral {
                 push<std::decay_t<A>>(luaState, std::forward<A>(firstArgument));
                 pushCopy(luaState, std::forward<B>(remainingArguments)...);
             }
+
+            template<typename R, typename V>
+            inline int pushReturnValue(lua_State *luaState, V &&value) {
+                return ReturnValue<std::decay_t<R>>::push(luaState, std::forward<V>(value));
+            }
+
+            template<typename R>
+            template<typename V>
+            inline int ReturnValue<R>::push(lua_State *luaState, V &&value) {
+                exchanger::push<R>(luaState, std::forward<V>(value));
+                return 1;
+            }
+
+            template<typename ...T>
+            template<typename V>
+            inline int ReturnValue<Returns<T...>>::push(lua_State *luaState, V &&value) {
+                push(luaState, std::forward<V>(value), std::index_sequence_for<T...>());
+                return static_cast<int>(sizeof...(T));
+            }
+
+            template<typename ...T>
+            template<typename V, std::size_t ...S>
+            // [[maybe_unused]]: see FunctionCaller<void, A...>::call
+            inline void ReturnValue<Returns<T...>>::push([[maybe_unused]] lua_State *luaState, [[maybe_unused]] V &&value, std::index_sequence<S...>) {
+                // each element is moved (if value is a rvalue) only once. The fold expression pushes the elements in order
+                (exchanger::push<T>(luaState, std::get<S>(std::forward<V>(value))), ...);
+            }
         }
     }
 }
@@ -30,10 +30,13 @@
 #include "Adaptor.hpp"
 #include "ArgumentException.hpp"
 #include "ClassMetatable.hpp"
+#include "CompactUserData.hpp"
+#include "ContainerView.hpp"
 #include "core.hpp"
 #include "DefaultArgument.hpp"
 #include "Global.hpp"
 #include "Pusher.hpp"
+#include "Returns.hpp"
 #include "State.hpp"
 #include "StateView.hpp"
 #include "Table.hpp"
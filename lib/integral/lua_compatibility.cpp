@@ -54,6 +54,50 @@ namespace integral {
             }
 #endif
 
+#if LUA_VERSION_NUM == 501
+            void rawgetp(lua_State *luaState, int index, const void *pointer) {
+                const int absoluteIndex = absindex(luaState, index);
+                lua_pushlightuserdata(luaState, const_cast<void *>(pointer));
+                lua_rawget(luaState, absoluteIndex);
+            }
+#endif
+
+#if LUA_VERSION_NUM == 501
+            void rawsetp(lua_State *luaState, int index, const void *pointer) {
+                const int absoluteIndex = absindex(luaState, index);
+                lua_pushlightuserdata(luaState, const_cast<void *>(pointer));
+                lua_insert(luaState, -2);
+                lua_rawset(luaState, absoluteIndex);
+            }
+#endif
+
+#if LUA_VERSION_NUM == 501
+            namespace {
+                // registry lightuserdata key (address)
+                const char keMainThreadKey = 0;
+            }
+
+            lua_State * getmainthread(lua_State *luaState) {
+                rawgetp(luaState, LUA_REGISTRYINDEX, &keMainThreadKey);
+                // stack: mainThread (?)
+                lua_State * const mainThread = lua_tothread(luaState, -1);
+                lua_pop(luaState, 1);
+                // stack:
+                if (mainThread != nullptr) {
+                    return mainThread;
+                }
+                if (lua_pushthread(luaState) == 1) {
+                    // stack: mainThread
+                    rawsetp(luaState, LUA_REGISTRYINDEX, &keMainThreadKey);
+                } else {
+                    // stack: thread
+                    lua_pop(luaState, 1);
+                }
+                // stack:
+                return luaState;
+            }
+#endif
+
 #if LUA_VERSION_NUM == 501
             void copy(lua_State *luaState, int fromIndex, int toIndex) {
                 // TODO test this
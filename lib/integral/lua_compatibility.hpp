@@ -79,6 +79,54 @@ namespace integral {
             }
 #endif
 
+#if LUA_VERSION_NUM == 501
+            void rawgetp(lua_State *luaState, int index, const void *pointer);
+#else
+            inline void rawgetp(lua_State *luaState, int index, const void *pointer) {
+                lua_rawgetp(luaState, index, pointer);
+            }
+#endif
+
+#if LUA_VERSION_NUM == 501
+            void rawsetp(lua_State *luaState, int index, const void *pointer);
+#else
+            inline void rawsetp(lua_State *luaState, int index, const void *pointer) {
+                lua_rawsetp(luaState, index, pointer);
+            }
+#endif
+
+#if LUA_VERSION_NUM < 503
+            inline void rawgeti(lua_State *luaState, int index, lua_Integer n) {
+                lua_rawgeti(luaState, index, static_cast<int>(n));
+            }
+#else
+            inline void rawgeti(lua_State *luaState, int index, lua_Integer n) {
+                lua_rawgeti(luaState, index, n);
+            }
+#endif
+
+#if LUA_VERSION_NUM < 503
+            inline void rawseti(lua_State *luaState, int index, lua_Integer n) {
+                lua_rawseti(luaState, index, static_cast<int>(n));
+            }
+#else
+            inline void rawseti(lua_State *luaState, int index, lua_Integer n) {
+                lua_rawseti(luaState, index, n);
+            }
+#endif
+
+#if LUA_VERSION_NUM == 501
+            // lua 5.1 has no LUA_RIDX_MAINTHREAD: the main thread is stored in the registry the first time this function is called from it. Until then, a coroutine gets itself
+            lua_State * getmainthread(lua_State *luaState);
+#else
+            inline lua_State * getmainthread(lua_State *luaState) {
+                lua_rawgeti(luaState, LUA_REGISTRYINDEX, LUA_RIDX_MAINTHREAD);
+                lua_State * const mainThread = lua_tothread(luaState, -1);
+                lua_pop(luaState, 1);
+                return mainThread;
+            }
+#endif
+
 #if LUA_VERSION_NUM == 501
             void copy(lua_State *luaState, int fromIndex, int toIndex);
 #else
@@ -141,6 +189,17 @@ namespace integral {
                 return lua_newuserdatauv(luaState, size, 1);
             }
 #endif
+
+#if LUA_VERSION_NUM < 504
+            // nUserValues is ignored: older lua versions have a fixed uservalue (environment) slot
+            inline void * newuserdatauv(lua_State *luaState, size_t size, int) {
+                return lua_newuserdata(luaState, size);
+            }
+#else
+            inline void * newuserdatauv(lua_State *luaState, size_t size, int nUserValues) {
+                return lua_newuserdatauv(luaState, size, nUserValues);
+            }
+#endif
         }
     }
 }
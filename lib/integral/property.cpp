@@ -0,0 +1,128 @@
+//
+//  property.cpp
+//  integral
+//
+// MIT License
+//
+// Copyright (c) 2024 André Pereira Henriques (aphenriques (at) outlook (dot) com)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include "property.hpp"
+#include <string>
+#include <lua.hpp>
+#include "exchanger.hpp"
+#include "UnexpectedStackException.hpp"
+
+namespace integral {
+    namespace detail {
+        namespace property {
+            const char * const gkPropertiesKey = "integral_PropertiesKey";
+
+            namespace {
+                // stack: object | name
+                // returns nullptr if "name" is not a property
+                const Accessor * getAccessor(lua_State *luaState) {
+                    lua_pushvalue(luaState, 2);
+                    // stack: object | name | name
+                    lua_rawget(luaState, lua_upvalueindex(1));
+                    // stack: object | name | accessorLightUserData?
+                    const Accessor * const accessor = static_cast<const Accessor *>(lua_touserdata(luaState, -1));
+                    lua_pop(luaState, 1);
+                    // stack: object | name
+                    return accessor;
+                }
+
+                const char * getPropertyName(lua_State *luaState) {
+                    return (lua_type(luaState, 2) == LUA_TSTRING) ? lua_tostring(luaState, 2) : "?";
+                }
+
+                // lua_CFunction (no C++ objects are alive when lua_error is called)
+                int callIndexMetamethod(lua_State *luaState) {
+                    // stack: object | name
+                    const Accessor * const accessor = getAccessor(luaState);
+                    if (accessor != nullptr) {
+                        return exchanger::callLuaFunction(luaState, accessor->getter_);
+                    }
+                    // same lookup as metatable.__index = metatable (methods and inheritance)
+                    if (lua_getmetatable(luaState, 1) == 0) {
+                        return 0;
+                    }
+                    // stack: object | name | metatable
+                    lua_pushvalue(luaState, 2);
+                    // stack: object | name | metatable | name
+                    lua_gettable(luaState, -2);
+                    // stack: object | name | metatable | value
+                    return 1;
+                }
+
+                // lua_CFunction (no C++ objects are alive when lua_error is called)
+                int callNewIndexMetamethod(lua_State *luaState) {
+                    // stack: object | name | value
+                    const Accessor * const accessor = getAccessor(luaState);
+                    if (accessor != nullptr && accessor->setter_ != nullptr) {
+                        return exchanger::callLuaFunction(luaState, accessor->setter_);
+                    }
+                    return luaL_error(luaState, "[integral] %s property '%s'", (accessor != nullptr) ? "read-only" : "unknown", getPropertyName(luaState));
+                }
+            }
+
+            void setAccessor(lua_State *luaState, const std::string &name, const Accessor *accessor) {
+                if (lua_istable(luaState, -1) != 0) {
+                    // stack: metatable
+                    lua_pushstring(luaState, gkPropertiesKey);
+                    lua_rawget(luaState, -2);
+                    // stack: metatable | properties?
+                    if (lua_istable(luaState, -1) == 0) {
+                        lua_pop(luaState, 1);
+                        // stack: metatable
+                        lua_newtable(luaState);
+                        // stack: metatable | properties*
+                        lua_pushstring(luaState, gkPropertiesKey);
+                        lua_pushvalue(luaState, -2);
+                        // stack: metatable | properties | gkPropertiesKey | properties
+                        lua_rawset(luaState, -4);
+                        // stack: metatable | properties
+                        lua_pushstring(luaState, "__index");
+                        lua_pushvalue(luaState, -2);
+                        lua_pushcclosure(luaState, &callIndexMetamethod, 1);
+                        // stack: metatable | properties | "__index" | callIndexMetamethod
+                        lua_rawset(luaState, -4);
+                        lua_pushstring(luaState, "__newindex");
+                        lua_pushvalue(luaState, -2);
+                        lua_pushcclosure(luaState, &callNewIndexMetamethod, 1);
+                        // stack: metatable | properties | "__newindex" | callNewIndexMetamethod
+                        lua_rawset(luaState, -4);
+                    }
+                    // stack: metatable | properties
+                    lua_pushstring(luaState, name.c_str());
+                    lua_pushlightuserdata(luaState, const_cast<Accessor *>(accessor));
+                    // stack: metatable | properties | name | accessorLightUserData
+                    lua_rawset(luaState, -3);
+                    // stack: metatable | properties
+                    lua_pop(luaState, 1);
+                    // stack: metatable
+                } else {
+                    throw UnexpectedStackException(luaState, __FILE__, __LINE__, __func__, "missing metatable to set property");
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,116 @@
+//
+//  property.hpp
+//  integral
+//
+// MIT License
+//
+// Copyright (c) 2024 André Pereira Henriques (aphenriques (at) outlook (dot) com)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#ifndef integral_property_hpp
+#define integral_property_hpp
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <lua.hpp>
+#include "exchanger.hpp"
+#include "IsTemplateClass.hpp"
+
+// class metatables with properties:
+// metatable[gkPropertiesKey] = properties = {[name] = accessorLightUserData}
+// metatable.__index = callIndexMetamethod (upvalue: properties). Names that are not properties are looked up in the metatable (methods and inheritance)
+// metatable.__newindex = callNewIndexMetamethod (upvalue: properties)
+// accessorLightUserData is the address of a static Accessor (one per member pointer)
+
+namespace integral {
+    namespace detail {
+        namespace property {
+            extern const char * const gkPropertiesKey;
+
+            class Accessor {
+            public:
+                // stack: object | name
+                lua_CFunction getter_;
+                // stack: object | name | value
+                // nullptr if the property is read-only
+                lua_CFunction setter_;
+            };
+
+            // true if pushing a value of type R creates a new userdata holding a copy (e.g.: registered classes and compact types). Reading such a member as a property would return a temporary: "object.member.field = value" would silently change the copy
+            // std::shared_ptr and std::reference_wrapper copies refer to the same object
+            template<typename R, typename Enable = void>
+            class IsCopiedUserData : public std::false_type {};
+
+            template<typename R>
+            class IsCopiedUserData<R, std::enable_if_t<std::is_class_v<R> && IsTemplateClass<std::shared_ptr, std::remove_cv_t<R>>::value == false && IsTemplateClass<std::reference_wrapper, std::remove_cv_t<R>>::value == false>> : public std::is_lvalue_reference<decltype(exchanger::Exchanger<std::remove_cv_t<R>>::get(nullptr, 0))> {};
+
+            // "M": data member pointer (e.g.: &Object::x_)
+            template<auto M>
+            class MemberAccessor;
+
+            template<typename T, typename R, R T::* M>
+            class MemberAccessor<M> {
+                static_assert(IsCopiedUserData<R>::value == false, "class type data members stored as userdata cannot be properties (reads would return copies): return a std::reference_wrapper from a method or use a std::shared_ptr member");
+
+            public:
+                static constexpr bool keIsReadOnly = std::is_const_v<R>;
+
+                static int getProperty(lua_State *luaState);
+                static int setProperty(lua_State *luaState);
+
+                static constexpr Accessor keAccessor{&getProperty, (keIsReadOnly == false) ? &setProperty : nullptr};
+            };
+
+            // stack argument: metatable
+            // installs __index and __newindex metamethods in the first call for a metatable
+            void setAccessor(lua_State *luaState, const std::string &name, const Accessor *accessor);
+
+            // stack argument: metatable
+            template<auto M>
+            inline void setProperty(lua_State *luaState, const std::string &name);
+
+            //--
+
+            template<typename T, typename R, R T::* M>
+            int MemberAccessor<M>::getProperty(lua_State *luaState) {
+                exchanger::push<R>(luaState, exchanger::get<T>(luaState, 1).*M);
+                return 1;
+            }
+
+            template<typename T, typename R, R T::* M>
+            int MemberAccessor<M>::setProperty(lua_State *luaState) {
+                if constexpr (keIsReadOnly == false) {
+                    exchanger::get<T>(luaState, 1).*M = exchanger::get<R>(luaState, 3);
+                }
+                return 0;
+            }
+
+            template<auto M>
+            inline void setProperty(lua_State *luaState, const std::string &name) {
+                setAccessor(luaState, name, &MemberAccessor<M>::keAccessor);
+            }
+        }
+    }
+}
+
+#endif
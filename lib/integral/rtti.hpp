@@ -0,0 +1,79 @@
+//
+//  rtti.hpp
+//  integral
+//
+// MIT License
+//
+// Copyright (c) 2024 André Pereira Henriques (aphenriques (at) outlook (dot) com)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#ifndef integral_rtti_hpp
+#define integral_rtti_hpp
+
+// INTEGRAL_WITH_RTTI is 1 if RTTI (typeid and dynamic_cast) is enabled, and 0 otherwise (e.g.: -fno-rtti)
+// integral does not require RTTI to identify types (see TypeKey). Without RTTI:
+// - objects can only be converted to base classes registered with defineInheritance/defineTypeFunction (there is no dynamic_cast fallback); and
+// - type names in error messages are not available.
+#if defined(__cpp_rtti) || defined(__GXX_RTTI) || defined(_CPPRTTI)
+#define INTEGRAL_WITH_RTTI 1
+#else
+#define INTEGRAL_WITH_RTTI 0
+#endif
+
+#if INTEGRAL_WITH_RTTI
+#include <typeinfo>
+#endif
+
+namespace integral {
+    namespace detail {
+        namespace rtti {
+            // typeid(T).name()
+            template<typename T>
+            inline const char * getTypeName();
+
+            // typeid(t).name() (dynamic type)
+            template<typename T>
+            inline const char * getTypeName(const T &t);
+
+            //--
+
+            template<typename T>
+            inline const char * getTypeName() {
+#if INTEGRAL_WITH_RTTI
+                return typeid(T).name();
+#else
+                return "(unknown type: no RTTI)";
+#endif
+            }
+
+            template<typename T>
+            inline const char * getTypeName([[maybe_unused]] const T &t) {
+#if INTEGRAL_WITH_RTTI
+                return typeid(t).name();
+#else
+                return getTypeName<T>();
+#endif
+            }
+        }
+    }
+}
+
+#endif
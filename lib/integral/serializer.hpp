@@ -30,7 +30,7 @@
 #include <sstream>
 #include <string>
 #include <type_traits>
-#include <typeinfo>
+#include "rtti.hpp"
 
 namespace integral {
     namespace detail {
@@ -61,7 +61,7 @@ namespace integral {
             template <typename T, typename Enable>
             std::string Serializer<T, Enable>::getString(const T &t) {
                 std::ostringstream stringStream;
-                stringStream << "object:["<< typeid(t).name() << "]";
+                stringStream << "object:["<< rtti::getTypeName(t) << "]";
                 return stringStream.str();
             }
 
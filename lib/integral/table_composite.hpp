@@ -33,6 +33,7 @@
 #include "Emplacer.hpp"
 #include "exchanger.hpp"
 #include "factory.hpp"
+#include "StaticFunctionWrapper.hpp"
 #include "type_manager.hpp"
 
 namespace integral {
@@ -55,6 +56,9 @@ namespace integral {
                 template<typename K, typename F, typename ...E, std::size_t ...I>
                 inline decltype(auto) setFunction(K &&key, F &&function, DefaultArgument<E, I> &&...defaultArguments) &&;
 
+                template<auto F, typename K>
+                inline decltype(auto) setFunction(K &&key) &&;
+
                 template<typename K, typename F>
                 inline decltype(auto) setLuaFunction(K &&key, F &&luaFunction) &&;
             };
@@ -119,6 +123,12 @@ namespace integral {
                 return std::move(*this).set(std::forward<K>(key), makeFunctionWrapper(std::forward<F>(function), std::move(defaultArguments)...));
             }
 
+            template<typename U>
+            template<auto F, typename K>
+            inline decltype(auto) TableCompositeInterface<U>::setFunction(K &&key) && {
+                return std::move(*this).set(std::forward<K>(key), StaticFunctionWrapper<F>());
+            }
+
             // TableComposite
             template<typename C, typename K, typename V>
             template<typename L, typename W>
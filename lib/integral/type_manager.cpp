@@ -26,106 +26,65 @@
 
 #include "type_manager.hpp"
 #include <cstddef>
-#include <typeindex>
+#include <cstring>
+#include <utility>
+#include <vector>
 #include <lua.hpp>
 #include "basic.hpp"
+#include "ConversionPath.hpp"
+#include "InlineCache.hpp"
 #include "lua_compatibility.hpp"
+#include "TypeFunction.hpp"
+#include "TypeKey.hpp"
 #include "UnexpectedStackException.hpp"
 
 namespace integral {
     namespace detail {
         namespace type_manager {
-            const char * const gkTypeManagerRegistryKey = "integral_TypeManagerRegistryKey";
-            const char * const gkTypeIndexKey = "integral_TypeIndexKey";
+            const char * const gkTypeManagerRegistryKey = "integral_TypeKeyManagerRegistryKey";
+            const char * const gkTypeKeyKey = "integral_TypeKeyKey";
             const char * const gkTypeManagerVersionKey = "integral_TypeManagerVersionKey";
-            const char * const gkTypeManagerVersion = "0.1";
-            const char * const gkTypeIndexMetatableName = "integral_TypeIndexMetatableName";
-            const char * const gkTypeFunctionsKey = "integral_TypeFunctionsKey";
-            const char * const gkUserDataWrapperBaseTableKey = "integral_UserDataWrapperBaseTableKey";
+            const char * const gkTypeManagerVersion = "0.2";
+            const char * const gkTypeFunctionsKey = "integral_TypeKeyFunctionsKey";
+            const char * const gkUserDataWrapperBaseTableKey = "integral_TypeKeyUserDataWrapperBaseTableKey";
             const char * const gkUnderlyingTypeFunctionKey = "integral_UnderlyingTypeFunctionKey";
+            const char * const gkUserDataWrapperAlignmentKey = "integral_UserDataWrapperAlignmentKey";
             const char * const gkInheritanceSearchTagKey = "integral_InheritanceSearchTagKey";
-            const char * const gkInheritanceKey = "integral_InheritanceKey";
+            const char * const gkInheritanceKey = "integral_TypeKeyInheritanceKey";
             const char * const gkInheritanceIndexMetamethodKey = "integral_InheritanceIndexMetamethodKey";
+            const char * const gkFlattenedFieldsKey = "integral_FlattenedFieldsKey";
 
-            const std::type_index * getClassMetatableType(lua_State *luaState) {
+            const void * getClassMetatableType(lua_State *luaState) {
                 //stack: metatable
-                lua_pushstring(luaState, gkTypeIndexKey);
-                //stack: metatable | gkTypeIndexKey
+                lua_pushstring(luaState, gkTypeKeyKey);
+                //stack: metatable | gkTypeKeyKey
                 lua_rawget(luaState, -2);
-                //stack: metatable | type_index (?)
-                if (lua_isuserdata(luaState, -1) != 0) {
-                    //stack: metatable | type_index (?)
-                    const std::type_index *userDataTypeIndex = basic::getAlignedObjectPointer<std::type_index>(luaState, -1, gkTypeIndexMetatableName);
-                    if (userDataTypeIndex != nullptr) {
-                        //stack: metatable | type_index
-                        lua_pop(luaState, 1);
-                        //stack: metatable
-                        return userDataTypeIndex;
-                    } else {
-                        //stack: metatable | ?
-                        throw UnexpectedStackException(luaState, __FILE__, __LINE__, __func__, "corrupted userdata type_index");
-                    }
-                } else {
-                    //stack: metatable | ?
-                    lua_pop(luaState, 1);
-                    return nullptr;
-                }
+                //stack: metatable | typeKey (?)
+                const void * const typeKey = lua_islightuserdata(luaState, -1) != 0 ? lua_touserdata(luaState, -1) : nullptr;
+                lua_pop(luaState, 1);
+                //stack: metatable
+                return typeKey;
             }
 
-            bool checkClassMetatableType(lua_State *luaState, const std::type_index &typeIndex) {
+            bool checkClassMetatableType(lua_State *luaState, const void *typeKey) {
                 //stack: metatable
-                const std::type_index * metatableTypeIndex = getClassMetatableType(luaState);
-                if (metatableTypeIndex != nullptr) {
-                    if (*metatableTypeIndex == typeIndex) {
-                        return true;
-                    } else {
-                        return false;
-                    }
-                } else {
-                    return false;
-                }
+                const void * const metatableTypeKey = getClassMetatableType(luaState);
+                return metatableTypeKey != nullptr && metatableTypeKey == typeKey;
             }
 
-            bool checkClassMetatableExistence(lua_State *luaState, const std::type_index &typeIndex) {
+            bool checkClassMetatableExistence(lua_State *luaState, const void *typeKey) {
                 lua_pushstring(luaState, gkTypeManagerRegistryKey);
                 //stack: gkTypeManagerRegistryKey
                 lua_rawget(luaState, LUA_REGISTRYINDEX);
                 //stack: typeManager (?)
                 if (lua_istable(luaState, -1) != 0) {
                     // stack: typeManager
-                    static_assert(sizeof(decltype(typeIndex.hash_code())) <= sizeof(lua_Integer), "lua_Integer cannot accommodate typeIndex.hash_code()");
-                    lua_pushinteger(luaState, static_cast<lua_Integer>(typeIndex.hash_code()));
-                    // stack: typeManager | typeHash
-                    lua_rawget(luaState, -2);
-                    // stack: typeManager | typeHashBucket (?)
-                    if (lua_istable(luaState, -1) != 0) {
-                        // stack: typeManager | typeHashBucket
-                        lua_remove(luaState, -2);
-                        // stack: typeHashBucket
-                        lua_pushnil(luaState);
-                        for (int hasNext = lua_next(luaState, -2); hasNext != 0; lua_pop(luaState, 1), hasNext = lua_next(luaState, -2)) {
-                            // stack: typeHashBucket | type_index_udata (?) | rootMetatable (?)
-                            std::type_index *storedTypeIndex = basic::getAlignedObjectPointer<std::type_index>(luaState, -2, gkTypeIndexMetatableName);
-                            if (storedTypeIndex != nullptr) {
-                                // stack: typeHashBucket | type_index_udata | rootMetatable (?)
-                                if (*storedTypeIndex == typeIndex) {
-                                    lua_pop(luaState, 3);
-                                    return true;
-                                }
-                            } else {
-                                // stack: typeHashBucket | ? | rootMetatable (?)
-                                throw UnexpectedStackException(luaState, __FILE__, __LINE__, __func__, "corrupted userdata type_index in typeHashBucket in typeManager");
-                            }
-                            // stack: typeHashBucket | type_index_udata (?) | rootMetatable (?)
-                        }
-                        // stack: typeHashBucket
-                        lua_pop(luaState, 1);
-                        return false;
-                    } else {
-                        // stack: typeManager | nil (?)
-                        lua_pop(luaState, 2);
-                        return false;
-                    }
+                    lua_compatibility::rawgetp(luaState, -1, typeKey);
+                    // stack: typeManager | rootMetatable (?)
+                    const bool isFound = lua_istable(luaState, -1) != 0;
+                    lua_pop(luaState, 2);
+                    // stack:
+                    return isFound;
                 } else {
                     // stack: nil (?)
                     lua_pop(luaState, 1);
@@ -133,77 +92,24 @@ namespace integral {
                 }
             }
 
-            void pushTypeIndexUserData(lua_State *luaState, const std::type_index &typeIndex) {
-                basic::pushAlignedObject<std::type_index>(luaState, typeIndex);
-                basic::pushClassMetatable<std::type_index>(luaState, gkTypeIndexMetatableName);
-                lua_setmetatable(luaState, -2);
-            }
-
-            void setTypeFunctionHashTable(lua_State *luaState, std::size_t baseTypeHash) {
-                // stack: metatable | typeFunctionTable
-                static_assert(sizeof(baseTypeHash) <= sizeof(lua_Integer), "lua_Integer cannot accommodate baseTypeHash");
-                lua_pushinteger(luaState, static_cast<lua_Integer>(baseTypeHash));
-                // stack: metatable | typeFunctionTable | typeHash
-                lua_newtable(luaState);
-                // stack: metatable | typeFunctionTable | typeHash | typeHashBucket*
-                lua_pushvalue(luaState, -1);
-                // stack: metatable | typeFunctionTable | typeHash | typeHashBucket* | typeHashBucket*
-                lua_insert(luaState, -4);
-                // stack: metatable | typeHashBucket* | typeFunctionTable | typeHash | typeHashBucket*
-                lua_rawset(luaState, -3);
-                // stack: metatable | typeHashBucket | typeFunctionTable
-                lua_pop(luaState, 1);
-                // stack: metatable | typeHashBucket
-            }
-
-            // this function should be used only for the creation of typeFunctionHashTable
-            void pushTypeFunctionHashTable(lua_State *luaState, const std::type_index &baseTypeIndex) {
+            // this function should be used only for the creation of a type function
+            void pushTypeFunctionTable(lua_State *luaState, const void *baseTypeKey) {
                 // stack: metatable
-                const std::size_t baseTypeHash = baseTypeIndex.hash_code();
                 lua_pushstring(luaState, gkTypeFunctionsKey);
                 // stack: metatable | gkTypeFunctionsKey
                 lua_rawget(luaState, -2);
                 // stack: metatable | typeFunctionTable (?)
                 if (lua_istable(luaState, -1) != 0) {
                     // stack: metatable | typeFunctionTable
-                    static_assert(sizeof(baseTypeHash) <= sizeof(lua_Integer), "lua_Integer cannot accommodate baseTypeHash");
-                    lua_pushinteger(luaState, static_cast<lua_Integer>(baseTypeHash));
-                    // stack: metatable | typeFunctionTable | typeHash
-                    lua_rawget(luaState, -2);
-                    // stack: metatable | typeFunctionTable | typeHashBucket (?)
-                    if (lua_istable(luaState, -1) == 0) {
-                        // stack:  metatable | typeFunctionTable | nil (?)
-                        lua_pop(luaState, 1);
-                        // stack:  metatable | typeFunctionTable
-                        setTypeFunctionHashTable(luaState, baseTypeHash);
-                        // stack: metatable | typeHashBucket
-                    } else {
-                        // stack: metatable | typeFunctionTable | typeHashBucket
-                        lua_remove(luaState, -2);
-                        // stack: metatable | typeHashBucket
-                        lua_pushnil(luaState);
-                        // stack: metatable | typeHashBucket | nil
-                        for (int hasNext = lua_next(luaState, -2); hasNext != 0; lua_pop(luaState, 1), hasNext = lua_next(luaState, -2)) {
-                            // stack: metatable | typeHashBucket | type_index_udata (?) | function (?)
-                            std::type_index *storedTypeIndex = basic::getAlignedObjectPointer<std::type_index>(luaState, -2, gkTypeIndexMetatableName);
-                            // stack: metatable | typeHashBucket | type_index_udata (?) | function (?)
-                            if (storedTypeIndex != nullptr) {
-                                // stack: metatable | typeHashBucket | type_index_udata | function (?)
-                                if (*storedTypeIndex == baseTypeIndex) {
-                                    // stack: metatable | typeHashBucket | type_index_udata | function (?)
-                                    throw exception::LogicException(__FILE__, __LINE__, __func__, "trying to set existing typeFunction");
-                                }
-                                // stack: metatable | typeHashBucket | type_index_udata | function (?)
-                                // [*]
-                            } else {
-                                // stack: metatable | typeHashBucket | ? | function (?)
-                                throw UnexpectedStackException(luaState, __FILE__, __LINE__, __func__, "corrupted TypeFunction typeHashBucket: expected type_index_udata at index -2");
-                            }
-                            // [-]
-                            // stack: metatable | typeHashBucket | type_index_udata | function (?)
-                        }
-                        // stack: metatable | typeHashBucket
+                    lua_compatibility::rawgetp(luaState, -1, baseTypeKey);
+                    // stack: metatable | typeFunctionTable | function (?)
+                    if (lua_isnil(luaState, -1) == 0) {
+                        // stack: metatable | typeFunctionTable | function
+                        throw exception::LogicException(__FILE__, __LINE__, __func__, "trying to set existing typeFunction");
                     }
+                    // stack: metatable | typeFunctionTable | nil
+                    lua_pop(luaState, 1);
+                    // stack: metatable | typeFunctionTable
                 } else {
                     // stack: metatable | nil (?)
                     lua_pop(luaState, 1);
@@ -216,12 +122,10 @@ namespace integral {
                     // stack: metatable | typeFunctionTable* | gkTypeFunctionsKey | typeFunctionTable*
                     lua_rawset(luaState, -4);
                     // stack: metatable | typeFunctionTable
-                    setTypeFunctionHashTable(luaState, baseTypeHash);
-                    // stack: metatable | typeHashBucket
                 }
             }
 
-            bool checkInheritanceTable(lua_State *luaState, const std::type_index &typeIndex) {
+            bool checkInheritanceTable(lua_State *luaState, const void *typeKey) {
                 // stack: inheritanceTable
                 const auto inheritanceTableLength = lua_compatibility::rawlen(luaState, -1);
                 for (std::size_t i = 1; i <= inheritanceTableLength; ++i) {
@@ -232,15 +136,14 @@ namespace integral {
                     // stack: inheritanceTable | baseTable (?)
                     if (lua_istable(luaState, -1) != 0) {
                         // stack: inheritanceTable | baseTable
-                        lua_rawgeti(luaState, -1, static_cast<lua_Integer>(InheritanceTable::kTypeIndexIndex));
-                        // stack: inheritanceTable | baseTable | baseTypeIndex (?)
-                        const std::type_index *baseTypeIndex = basic::getAlignedObjectPointer<std::type_index>(luaState, -1, gkTypeIndexMetatableName);
-                        // stack: inheritanceTable | baseTable | baseTypeIndex (?)
-                        if (baseTypeIndex != nullptr) {
-                            // stack: inheritanceTable | baseTable | baseTypeIndex
+                        lua_rawgeti(luaState, -1, static_cast<lua_Integer>(InheritanceTable::kTypeKeyIndex));
+                        // stack: inheritanceTable | baseTable | baseTypeKey (?)
+                        if (lua_islightuserdata(luaState, -1) != 0) {
+                            // stack: inheritanceTable | baseTable | baseTypeKey
+                            const void * const baseTypeKey = lua_touserdata(luaState, -1);
                             lua_pop(luaState, 2);
                             // stack: inheritanceTable
-                            if (*baseTypeIndex == typeIndex) {
+                            if (baseTypeKey == typeKey) {
                                 // stack: inheritanceTable
                                 return true;
                             }
@@ -248,7 +151,7 @@ namespace integral {
                             // [*]
                         } else {
                             // stack: inheritanceTable | baseTable | ?
-                            throw UnexpectedStackException(luaState, __FILE__, __LINE__, __func__, "corrupted inheritanceTable: expected baseTypeIndex at index -1");
+                            throw UnexpectedStackException(luaState, __FILE__, __LINE__, __func__, "corrupted inheritanceTable: expected baseTypeKey at index -1");
                         }
                     } else {
                         // stack: inheritanceTable | ?
@@ -313,231 +216,414 @@ namespace integral {
                 // stack:
             }
 
-            bool pushDirectConvertibleType(lua_State *luaState, int index, const std::type_index &convertibleTypeIndex) {
+            int callTypeFunction(lua_State *luaState) {
+                const TypeFunction &typeFunction = *static_cast<const TypeFunction *>(lua_touserdata(luaState, lua_upvalueindex(1)));
+                // Attention! light userdata does not require alignment ajustment with basic::getAlignedObjectPointer (UnderlyingTypeFunction adjusts userdata alignment)
+                void * const object = lua_touserdata(luaState, 1);
+                if (object != nullptr) {
+                    lua_pushlightuserdata(luaState, typeFunction(object));
+                    return 1;
+                } else {
+                    throw UnexpectedStackException(luaState, __FILE__, __LINE__, __func__, "type function expected underlying lightuserdata");
+                }
+            }
+
+            void pushTypeFunctionClosure(lua_State *luaState, const TypeFunction &typeFunction, bool hasOwner) {
+                // stack: [owner]
+                lua_pushlightuserdata(luaState, const_cast<TypeFunction *>(&typeFunction));
+                // stack: [owner] | typeFunctionLightUserData
+                if (hasOwner == true) {
+                    // stack: owner | typeFunctionLightUserData
+                    lua_insert(luaState, -2);
+                    // stack: typeFunctionLightUserData | owner
+                    lua_pushcclosure(luaState, &callTypeFunction, 2);
+                } else {
+                    // stack: typeFunctionLightUserData
+                    lua_pushcclosure(luaState, &callTypeFunction, 1);
+                }
+                // stack: function
+            }
+
+            const TypeFunction * getNativeTypeFunction(lua_State *luaState) {
+                // stack: typeFunction
+                if (lua_tocfunction(luaState, -1) == &callTypeFunction && lua_getupvalue(luaState, -1, 1) != nullptr) {
+                    // stack: typeFunction | typeFunctionLightUserData
+                    const TypeFunction *typeFunction = static_cast<const TypeFunction *>(lua_touserdata(luaState, -1));
+                    lua_pop(luaState, 1);
+                    // stack: typeFunction
+                    return typeFunction;
+                } else {
+                    // stack: typeFunction
+                    return nullptr;
+                }
+            }
+
+            bool checkConstantOffsetTypeFunction(lua_State *luaState) {
+                // stack: typeFunction
+                const TypeFunction *typeFunction = getNativeTypeFunction(luaState);
+                if (typeFunction != nullptr) {
+                    return typeFunction->isConstantOffset_;
+                }
+                // type function from a different integral version: only custom type functions have up values
+                if (lua_getupvalue(luaState, -1, 1) == nullptr) {
+                    // stack: typeFunction
+                    return true;
+                } else {
+                    // stack: typeFunction | upValue
+                    lua_pop(luaState, 1);
+                    // stack: typeFunction
+                    return false;
+                }
+            }
+
+            bool pushTypeFunction(lua_State *luaState, const void *typeKey) {
                 // stack: metatable
-                lua_pushvalue(luaState, index);
-                // stack: metatable | [underlyingLight]UserData (?)
-                lua_insert(luaState, -2);
-                // stack: [underlyingLight]UserData (?) | metatable
                 lua_pushstring(luaState, gkTypeFunctionsKey);
-                // stack: [underlyingLight]UserData (?) | metatable | gkTypeFunctionsKey
+                // stack: metatable | gkTypeFunctionsKey
                 lua_rawget(luaState, -2);
-                // stack: [underlyingLight]UserData (?) | metatable | typeFunctionTable (?)
+                // stack: metatable | typeFunctionTable (?)
                 if (lua_istable(luaState, -1) != 0) {
-                    // stack: [underlyingLight]UserData (?) | metatable | typeFunctionTable
-                    static_assert(sizeof(decltype(convertibleTypeIndex.hash_code())) <= sizeof(lua_Integer), "lua_Integer cannot accommodate convertibleTypeIndex.hash_code()");
-                    lua_pushinteger(luaState, static_cast<lua_Integer>(convertibleTypeIndex.hash_code()));
-                    // stack: [underlyingLight]UserData (?) | metatable | typeFunctionTable | typeHash
-                    lua_rawget(luaState, -2);
-                    // stack: [underlyingLight]UserData (?) | metatable | typeFunctionTable | typeHashBucket (?)
-                    if (lua_istable(luaState, -1) != 0) {
-                        // stack: [underlyingLight]UserData (?) | metatable | typeFunctionTable | typeHashBucket
+                    // stack: metatable | typeFunctionTable
+                    lua_compatibility::rawgetp(luaState, -1, typeKey);
+                    // stack: metatable | typeFunctionTable | function (?)
+                    if (lua_iscfunction(luaState, -1) != 0) {
+                        // stack: metatable | typeFunctionTable | function
                         lua_remove(luaState, -2);
-                        // stack: [underlyingLight]UserData (?) | metatable | typeHashBucket
-                        lua_pushnil(luaState);
-                        // stack: [underlyingLight]UserData (?) | metatable | typeHashBucket | nil
-                        for (int hasNext = lua_next(luaState, -2); hasNext != 0; lua_pop(luaState, 1), hasNext = lua_next(luaState, -2)) {
-                            // stack: [underlyingLight]UserData (?) | metatable | typeHashBucket | type_index_udata (?) | function (?)
-                            std::type_index *storedTypeIndex = basic::getAlignedObjectPointer<std::type_index>(luaState, -2, gkTypeIndexMetatableName);
-                            if (storedTypeIndex != nullptr) {
-                                if (*storedTypeIndex == convertibleTypeIndex) {
-                                    // stack: [underlyingLight]UserData (?) | metatable | typeHashBucket | type_index_udata | function (?)
-                                    lua_remove(luaState, -2);
-                                    // stack: [underlyingLight]UserData (?) | metatable | typeHashBucket | function (?)
-                                    lua_remove(luaState, -2);
-                                    // stack: [underlyingLight]UserData (?) | metatable | function (?)
-                                    if (lua_iscfunction(luaState, -1) != 0) {
-                                        // stack: [underlyingLight]UserData (?) | metatable | function
-                                        if (lua_islightuserdata(luaState, -3) == 0) {
-                                            // stack: userData (?) | metatable | function
-                                            if (lua_isuserdata(luaState, -3) != 0) {
-                                                // stack: userData | metatable | function
-                                                lua_insert(luaState, -2);
-                                                // stack: userdata | function | metatable
-                                                if (pushUnderlyingTypeLightUserData(luaState, -3) == true) {
-                                                    // stack: userdata | function | underlyingLightUserData
-                                                    lua_remove(luaState, -3);
-                                                    // stack: function | underlyingLightUserData
-                                                    // [*]
-                                                } else {
-                                                    // stack: userdata | function
-                                                    throw UnexpectedStackException(luaState, __FILE__, __LINE__, __func__, "corrupted UnderlyingTypeFunction");
-                                                }
-                                            } else {
-                                                // stack: ? | metatable | function
-                                                throw UnexpectedStackException(luaState, __FILE__, __LINE__, __func__, "failed to push direct convertible type: value at index -3 is neither a lightuserdata nor userdata");
-                                            }
-                                        } else {
-                                            // stack: underlyingLightUserData | metatable | function
-                                            lua_remove(luaState, -2);
-                                            // stack: underlyingLightUserData | function
-                                            lua_insert(luaState, -2);
-                                            // stack: function | underlyingLightUserData
-                                        }
-                                        // [-]
-                                        // stack: function | underlyingLightUserData
-                                        lua_call(luaState, 1, 1);
-                                        // stack: convertedLighuserdata (?)
-                                        if (lua_islightuserdata(luaState, -1) != 0) {
-                                            // stack: convertedLighuserdata
-                                            return true;
-                                        } else {
-                                            // stack: ?
-                                            throw UnexpectedStackException(luaState, __FILE__, __LINE__, __func__, "corrupted TypeFunction typeHashBucket: expected convertedLightUserData at index -1");
-                                        }
-                                    } else {
-                                        // stack: [underlyingLight]UserData (?) | metatable | ?
-                                        throw UnexpectedStackException(luaState, __FILE__, __LINE__, __func__, "corrupted TypeFunction typeHashBucket: expected cfunction at index -1");
-                                    }
-                                }
-                            } else {
-                                // stack: [underlyingLight]UserData (?) | metatable | typeHashBucket | ? | function (?)
-                                throw UnexpectedStackException(luaState, __FILE__, __LINE__, __func__, "corrupted TypeFunction typeHashBucket: expected type_index_udata at index -2");
-                            }
-                            // stack: [underlyingLight]UserData (?) | metatable | typeHashBucket | type_index_udata | function (?)
-                        }
-                        // stack: [underlyingLight]UserData (?) | metatable | typeHashBucket
-                        lua_pop(luaState, 3);
-                    } else {
-                        // stack: [underlyingLight]UserData (?) | metatable | typeFunctionTable | nil (?)
-                        lua_pop(luaState, 4);
+                        // stack: metatable | function
+                        return true;
+                    } else if (lua_isnil(luaState, -1) == 0) {
+                        // stack: metatable | typeFunctionTable | ?
+                        throw UnexpectedStackException(luaState, __FILE__, __LINE__, __func__, "corrupted typeFunctionTable: expected cfunction at index -1");
                     }
+                    // stack: metatable | typeFunctionTable | nil
+                    lua_pop(luaState, 2);
                 } else {
-                    // stack: [underlyingLight]UserData (?) | metatable | nil (?)
-                    lua_pop(luaState, 3);
+                    // stack: metatable | nil (?)
+                    lua_pop(luaState, 1);
                 }
+                // stack: metatable
                 return false;
             }
 
-            bool pushConvertibleOrInheritedType(lua_State *luaState, int index, const std::type_index &convertibleTypeIndex, bool isRecursion) {
+            bool searchConversionPath(lua_State *luaState, const void *convertibleTypeKey, int pathIndex) {
                 // stack: metatable
-                if (isRecursion == false || checkInheritanceSearchTag(luaState, -1) == false) {
+                if (checkInheritanceSearchTag(luaState, -1) == true) { // avoids infinite recursion
                     // stack: metatable
-                    lua_pushvalue(luaState, index);
-                    // stack: metatable | [underlyingLight]UserData (?)
-                    lua_insert(luaState, -2);
-                    // stack: [underlyingLight]UserData (?) | metatable
-                    lua_pushvalue(luaState, -1);
-                    // stack: [underlyingLight]UserData (?) | metatable | metatable
-                    if (pushDirectConvertibleType(luaState, -3, convertibleTypeIndex) == true) {
-                        // stack: underlyingLightUserData | metatable | convertedLightUserData
-                        lua_remove(luaState, -2);
-                        // stack: underlyingLightUserData | convertedLightUserData
-                        lua_remove(luaState, -2);
-                        // stack: convertedLightUserData
-                        return true;
-                    } else {
-                        // stack: [underlyingLight]UserData (?) | metatable
-                        lua_pushstring(luaState, gkInheritanceKey);
-                        // stack: [underlyingLight]UserData (?) | metatable | gkInheritanceKey
+                    lua_pop(luaState, 1);
+                    return false;
+                }
+                // stack: metatable
+                if (pushTypeFunction(luaState, convertibleTypeKey) == true) {
+                    // stack: metatable | function
+                    lua_rawseti(luaState, pathIndex, static_cast<lua_Integer>(lua_compatibility::rawlen(luaState, pathIndex) + 1));
+                    // stack: metatable
+                    lua_pop(luaState, 1);
+                    return true;
+                }
+                // stack: metatable
+                lua_pushstring(luaState, gkInheritanceKey);
+                // stack: metatable | gkInheritanceKey
+                lua_rawget(luaState, -2);
+                // stack: metatable | inheritanceTable (?)
+                if (lua_istable(luaState, -1) != 0) {
+                    // stack: metatable | inheritanceTable
+                    for (auto i = lua_compatibility::rawlen(luaState, -1); i >= 1; --i) {
+                        // stack: metatable | inheritanceTable
+                        lua_compatibility::pushunsigned(luaState, i);
+                        // stack: metatable | inheritanceTable | i
                         lua_rawget(luaState, -2);
-                        // stack: [underlyingLight]UserData (?) | metatable | inheritanceTable (?)
+                        // stack: metatable | inheritanceTable | baseTable (?)
                         if (lua_istable(luaState, -1) != 0) {
-                            // stack: [underlyingLight]UserData (?) | metatable | inheritanceTable
-                            if (isRecursion == false) {
-                                // stack: userData (?) | metatable | inheritanceTable
-                                lua_pushvalue(luaState, -2);
-                                // stack: userdata (?) | metatable | inheritanceTable | metatable
-                                if (lua_isuserdata(luaState, -4) != 0) {
-                                    // stack: userdata | metatable | inheritanceTable | metatable
-                                    if (pushUnderlyingTypeLightUserData(luaState, -4) == true) {
-                                        // stack: userdata | metatable | inheritanceTable | underlyingLightUserData
-                                        lua_remove(luaState, -4);
-                                        // stack: metatable | inheritanceTable | underlyingLightUserData
-                                        lua_insert(luaState, -3);
-                                        // stack: underlyingLightUserData | metatable | inheritanceTable
-                                        // [*]
-                                    } else {
-                                        // stack: userdata | metatable | inheritanceTable
-                                        throw UnexpectedStackException(luaState, __FILE__, __LINE__, __func__, "corrupted UnderlyingTypeFunction");
-                                    }
-                                } else {
-                                    // stack: ? | metatable | inheritanceTable | metatable
-                                    throw UnexpectedStackException(luaState, __FILE__, __LINE__, __func__, "failed to push convertible or inherited type: value at index -4 is not userdata");
-                                }
-                            }
-                            // [-]
-                            // stack: underlyingLightUserData | metatable | inheritanceTable
-                            for (auto i = lua_compatibility::rawlen(luaState, -1); i >= 1; --i) {
-                                // stack: underlyingLightUserData | metatable | inheritanceTable
-                                lua_compatibility::pushunsigned(luaState, i);
-                                // stack: underlyingLightUserData | metatable | inheritanceTable | i
-                                lua_rawget(luaState, -2);
-                                // stack: underlyingLightUserData | metatable | inheritanceTable | baseTable (?)
-                                if (lua_istable(luaState, -1) != 0) {
-                                    // stack: underlyingLightUserData | metatable | inheritanceTable | baseTable
-                                    lua_rawgeti(luaState, -1, static_cast<lua_Integer>(InheritanceTable::kMetatableIndex));
-                                    // stack: underlyingLightUserData | metatable | inheritanceTable | baseTable | baseMetatable (?)
-                                    if (lua_istable(luaState, -1) != 0) {
-                                        // stack: underlyingLightUserData | metatable | inheritanceTable | baseTable | baseMetatable
-                                        lua_rawgeti(luaState, -2, static_cast<lua_Integer>(InheritanceTable::kTypeIndexIndex));
-                                        // stack: underlyingLightUserData | metatable | inheritanceTable | baseTable | baseMetatable | baseTypeIndex (?)
-                                        const std::type_index *baseTypeIndex = basic::getAlignedObjectPointer<std::type_index>(
-                                            luaState,
-                                            -1,
-                                            gkTypeIndexMetatableName
-                                        );
-                                        if (baseTypeIndex != nullptr) {
-                                            // stack: underlyingLightUserData | metatable | inheritanceTable | baseTable | baseMetatable | baseTypeIndex
-                                            lua_pop(luaState, 1);
-                                            // stack: underlyingLightUserData | metatable | inheritanceTable | baseTable | baseMetatable
-                                            lua_remove(luaState, -2);
-                                            // stack: underlyingLightUserData | metatable | inheritanceTable | baseMetatable
-                                            lua_pushvalue(luaState, -3);
-                                            // stack: underlyingLightUserData | metatable | inheritanceTable | baseMetatable | metatable
-                                            if (pushDirectConvertibleType(luaState, -5, *baseTypeIndex) == true) {
-                                                // stack: underlyingLightUserData | metatable | inheritanceTable | baseMetatable | baseClassLightUserData
-                                                lua_insert(luaState, -2);
-                                                // stack: underlyingLightUserData | metatable | inheritanceTable | baseClassLightUserData | baseMetatable
-                                                tagInheritanceSearch(luaState, -4);
-                                                if (pushConvertibleOrInheritedType(luaState, -2, convertibleTypeIndex, true) == true) {
-                                                    // stack: underlyingLightUserData | metatable | inheritanceTable | baseClassLightUserData | lightUserData
-                                                    untagInheritanceSearch(luaState, -4);
-                                                    lua_insert(luaState, -5);
-                                                    // stack: lightUserData | underlyingLightUserData | metatable | inheritanceTable | baseClassLightUserData
-                                                    lua_pop(luaState, 4);
-                                                    return true;
-                                                } else {
-                                                    // stack: underlyingLightUserData | metatable | inheritanceTable | baseClassLightUserData
-                                                    untagInheritanceSearch(luaState, -3);
-                                                    lua_pop(luaState, 1);
-                                                    // stack: underlyingLightUserData | metatable | inheritanceTable
-                                                    // [*]
-                                                }
-                                            } else {
-                                                // stack: underlyingLightUserData | metatable | inheritanceTable | baseMetatable
-                                                throw UnexpectedStackException(luaState, __FILE__, __LINE__, __func__, "corrupted inheritanceTable: there should be a conversion function for a inherited type");
-                                            }
-                                        } else {
-                                            // stack: underlyingLightUserData | metatable | inheritanceTable | baseTable | baseMetatable | ?
-                                            throw UnexpectedStackException(luaState, __FILE__, __LINE__, __func__, "corrupted inheritanceTable: expected baseTypeIndex at index -1");
+                            // stack: metatable | inheritanceTable | baseTable
+                            lua_rawgeti(luaState, -1, static_cast<lua_Integer>(InheritanceTable::kMetatableIndex));
+                            // stack: metatable | inheritanceTable | baseTable | baseMetatable (?)
+                            if (lua_istable(luaState, -1) != 0) {
+                                // stack: metatable | inheritanceTable | baseTable | baseMetatable
+                                lua_rawgeti(luaState, -2, static_cast<lua_Integer>(InheritanceTable::kTypeKeyIndex));
+                                // stack: metatable | inheritanceTable | baseTable | baseMetatable | baseTypeKey (?)
+                                if (lua_islightuserdata(luaState, -1) != 0) {
+                                    // stack: metatable | inheritanceTable | baseTable | baseMetatable | baseTypeKey
+                                    const void * const baseTypeKey = lua_touserdata(luaState, -1);
+                                    lua_pushvalue(luaState, -5);
+                                    // stack: metatable | inheritanceTable | baseTable | baseMetatable | baseTypeKey | metatable
+                                    if (pushTypeFunction(luaState, baseTypeKey) == true) {
+                                        // stack: metatable | inheritanceTable | baseTable | baseMetatable | baseTypeKey | metatable | baseFunction
+                                        const auto pathLength = lua_compatibility::rawlen(luaState, pathIndex);
+                                        lua_rawseti(luaState, pathIndex, static_cast<lua_Integer>(pathLength + 1));
+                                        // stack: metatable | inheritanceTable | baseTable | baseMetatable | baseTypeKey | metatable
+                                        lua_pop(luaState, 2);
+                                        // stack: metatable | inheritanceTable | baseTable | baseMetatable
+                                        lua_remove(luaState, -2);
+                                        // stack: metatable | inheritanceTable | baseMetatable
+                                        tagInheritanceSearch(luaState, -3);
+                                        const bool isFound = searchConversionPath(luaState, convertibleTypeKey, pathIndex);
+                                        // stack: metatable | inheritanceTable
+                                        untagInheritanceSearch(luaState, -2);
+                                        if (isFound == true) {
+                                            lua_pop(luaState, 2);
+                                            // stack:
+                                            return true;
                                         }
+                                        // a failed search does not append to the conversion path: only baseFunction is removed
+                                        lua_pushnil(luaState);
+                                        // stack: metatable | inheritanceTable | nil
+                                        lua_rawseti(luaState, pathIndex, static_cast<lua_Integer>(pathLength + 1));
+                                        // stack: metatable | inheritanceTable
+                                        // [*]
                                     } else {
-                                        // stack: underlyingLightUserData | metatable | inheritanceTable | baseTable | ?
-                                        throw UnexpectedStackException(luaState, __FILE__, __LINE__, __func__, "corrupted inheritanceTable: expected baseMetatable at index -1");
-
+                                        // stack: metatable | inheritanceTable | baseTable | baseMetatable | baseTypeKey | metatable
+                                        throw UnexpectedStackException(luaState, __FILE__, __LINE__, __func__, "corrupted inheritanceTable: there should be a conversion function for a inherited type");
                                     }
                                 } else {
-                                    // stack: underlyingLightUserData | metatable | inheritanceTable | ?
-                                    throw UnexpectedStackException(luaState, __FILE__, __LINE__, __func__, "corrupted inheritanceTable: expected baseTable at index -1");
+                                    // stack: metatable | inheritanceTable | baseTable | baseMetatable | ?
+                                    throw UnexpectedStackException(luaState, __FILE__, __LINE__, __func__, "corrupted inheritanceTable: expected baseTypeKey at index -1");
                                 }
-                                // [-]
-                                // stack: underlyingLightUserData | metatable | inheritanceTable
+                            } else {
+                                // stack: metatable | inheritanceTable | baseTable | ?
+                                throw UnexpectedStackException(luaState, __FILE__, __LINE__, __func__, "corrupted inheritanceTable: expected baseMetatable at index -1");
                             }
-                            // stack: underlyingLightUserData | metatable | inheritanceTable
-                            lua_pop(luaState, 3);
-                            return false;
                         } else {
-                            // stack: underlyingLightUserData | metatable | nil (?)
-                            lua_pop(luaState, 3);
-                            return false;
+                            // stack: metatable | inheritanceTable | ?
+                            throw UnexpectedStackException(luaState, __FILE__, __LINE__, __func__, "corrupted inheritanceTable: expected baseTable at index -1");
                         }
+                        // [-]
+                        // stack: metatable | inheritanceTable
                     }
-                } else { // avoids infinite recursion
+                }
+                // stack: metatable | inheritanceTable or nil (?)
+                lua_pop(luaState, 2);
+                return false;
+            }
+
+            void pushMetatableConversionPaths(lua_State *luaState) {
+                // stack: metatable
+                lua_compatibility::rawgetp(luaState, LUA_REGISTRYINDEX, TypeKey<ConversionPathCache>::get());
+                // stack: metatable | conversionPathCache (?)
+                if (lua_istable(luaState, -1) == 0) {
+                    // stack: metatable | nil (?)
+                    lua_pop(luaState, 1);
                     // stack: metatable
+                    lua_newtable(luaState);
+                    // stack: metatable | conversionPathCache*
+                    // weak keys: metatables of non integral userdata might be collected
+                    lua_createtable(luaState, 0, 1);
+                    // stack: metatable | conversionPathCache* | conversionPathCacheMetatable*
+                    lua_pushstring(luaState, "__mode");
+                    // stack: metatable | conversionPathCache* | conversionPathCacheMetatable* | "__mode"
+                    lua_pushstring(luaState, "k");
+                    // stack: metatable | conversionPathCache* | conversionPathCacheMetatable* | "__mode" | "k"
+                    lua_rawset(luaState, -3);
+                    // stack: metatable | conversionPathCache* | conversionPathCacheMetatable*
+                    lua_setmetatable(luaState, -2);
+                    // stack: metatable | conversionPathCache*
+                    lua_pushvalue(luaState, -1);
+                    // stack: metatable | conversionPathCache* | conversionPathCache*
+                    lua_compatibility::rawsetp(luaState, LUA_REGISTRYINDEX, TypeKey<ConversionPathCache>::get());
+                    // stack: metatable | conversionPathCache
+                }
+                // stack: metatable | conversionPathCache
+                lua_pushvalue(luaState, -2);
+                // stack: metatable | conversionPathCache | metatable
+                lua_rawget(luaState, -2);
+                // stack: metatable | conversionPathCache | metatableConversionPaths (?)
+                if (lua_istable(luaState, -1) == 0) {
+                    // stack: metatable | conversionPathCache | nil (?)
                     lua_pop(luaState, 1);
-                    return false;
+                    // stack: metatable | conversionPathCache
+                    lua_newtable(luaState);
+                    // stack: metatable | conversionPathCache | metatableConversionPaths*
+                    lua_pushvalue(luaState, -3);
+                    // stack: metatable | conversionPathCache | metatableConversionPaths* | metatable
+                    lua_pushvalue(luaState, -2);
+                    // stack: metatable | conversionPathCache | metatableConversionPaths* | metatable | metatableConversionPaths*
+                    lua_rawset(luaState, -4);
+                    // stack: metatable | conversionPathCache | metatableConversionPaths
+                }
+                // stack: metatable | conversionPathCache | metatableConversionPaths
+                lua_remove(luaState, -2);
+                // stack: metatable | metatableConversionPaths
+            }
+
+            void pushConversionPath(lua_State *luaState, const void *convertibleTypeKey) {
+                // stack: metatable
+                pushMetatableConversionPaths(luaState);
+                // stack: metatable | metatableConversionPaths
+                lua_compatibility::rawgetp(luaState, -1, convertibleTypeKey);
+                // stack: metatable | metatableConversionPaths | conversionPath or false (?)
+                if (lua_isnil(luaState, -1) != 0) {
+                    // stack: metatable | metatableConversionPaths | nil
+                    lua_pop(luaState, 1);
+                    // stack: metatable | metatableConversionPaths
+                    lua_newtable(luaState);
+                    // stack: metatable | metatableConversionPaths | conversionPath*
+                    lua_pushvalue(luaState, -3);
+                    // stack: metatable | metatableConversionPaths | conversionPath* | metatable
+                    if (searchConversionPath(luaState, convertibleTypeKey, lua_compatibility::absindex(luaState, -2)) == true) {
+                        // stack: metatable | metatableConversionPaths | conversionPath*
+                        setNativeConversionPath(luaState, lua_compatibility::absindex(luaState, -3));
+                        // stack: metatable | metatableConversionPaths | [native]conversionPath*
+                    } else {
+                        // stack: metatable | metatableConversionPaths | conversionPath*
+                        lua_pop(luaState, 1);
+                        // stack: metatable | metatableConversionPaths
+                        lua_pushboolean(luaState, 0);
+                        // stack: metatable | metatableConversionPaths | false
+                    }
+                    // stack: metatable | metatableConversionPaths | conversionPath or false
+                    lua_pushvalue(luaState, -1);
+                    // stack: metatable | metatableConversionPaths | conversionPath or false | conversionPath or false
+                    lua_compatibility::rawsetp(luaState, -3, convertibleTypeKey);
+                    // stack: metatable | metatableConversionPaths | conversionPath or false
+                }
+                // stack: metatable | metatableConversionPaths | conversionPath or false
+                lua_remove(luaState, -2);
+                // stack: metatable | conversionPath or false
+            }
+
+            void setNativeConversionPath(lua_State *luaState, int metatableIndex) {
+                // stack: conversionPath
+                lua_pushstring(luaState, gkUnderlyingTypeFunctionKey);
+                // stack: conversionPath | gkUnderlyingTypeFunctionKey
+                lua_rawget(luaState, metatableIndex);
+                // stack: conversionPath | underlyingTypeFunction (?)
+                const TypeFunction * const underlyingTypeFunction = getNativeTypeFunction(luaState);
+                lua_pop(luaState, 1);
+                // stack: conversionPath
+                if (underlyingTypeFunction != nullptr) {
+                    const auto pathLength = lua_compatibility::rawlen(luaState, -1);
+                    std::vector<const TypeFunction *> typeFunctions;
+                    typeFunctions.reserve(pathLength);
+                    for (std::size_t i = 1; i <= pathLength; ++i) {
+                        lua_rawgeti(luaState, -1, static_cast<lua_Integer>(i));
+                        // stack: conversionPath | typeFunction
+                        const TypeFunction * const typeFunction = getNativeTypeFunction(luaState);
+                        lua_pop(luaState, 1);
+                        // stack: conversionPath
+                        if (typeFunction == nullptr) {
+                            return;
+                        }
+                        typeFunctions.push_back(typeFunction);
+                    }
+                    // stack: conversionPath
+                    basic::pushAlignedObject<ConversionPath>(luaState, *underlyingTypeFunction, std::move(typeFunctions));
+                    // stack: conversionPath | nativeConversionPath_udata_no_metatable
+                    basic::pushClassMetatable<ConversionPath>(luaState);
+                    // stack: conversionPath | nativeConversionPath_udata_no_metatable | nativeConversionPath_udata_metatable
+                    lua_setmetatable(luaState, -2);
+                    // stack: conversionPath | nativeConversionPath
+                    lua_remove(luaState, -2);
+                    // stack: nativeConversionPath
+                }
+            }
+
+            void setConstantOffsetConversionPath(lua_State *luaState, int index, const void *convertibleTypeKey, void *object) {
+                index = lua_compatibility::absindex(luaState, index);
+                if (lua_getmetatable(luaState, index) == 0) {
+                    return;
+                }
+                // stack: metatable
+                lua_pushstring(luaState, gkUnderlyingTypeFunctionKey);
+                // stack: metatable | gkUnderlyingTypeFunctionKey
+                lua_rawget(luaState, -2);
+                // stack: metatable | underlyingTypeFunction (?)
+                const TypeFunction * const underlyingTypeFunction = getNativeTypeFunction(luaState);
+                lua_pop(luaState, 1);
+                // stack: metatable
+                if (underlyingTypeFunction != nullptr) {
+                    const std::ptrdiff_t offset = static_cast<char *>(object) - static_cast<char *>((*underlyingTypeFunction)(lua_touserdata(luaState, index)));
+                    pushMetatableConversionPaths(luaState);
+                    // stack: metatable | metatableConversionPaths
+                    basic::pushAlignedObject<ConversionPath>(luaState, *underlyingTypeFunction, offset);
+                    // stack: metatable | metatableConversionPaths | nativeConversionPath_udata_no_metatable
+                    basic::pushClassMetatable<ConversionPath>(luaState);
+                    // stack: metatable | metatableConversionPaths | nativeConversionPath_udata_no_metatable | nativeConversionPath_udata_metatable
+                    lua_setmetatable(luaState, -2);
+                    // stack: metatable | metatableConversionPaths | nativeConversionPath
+                    lua_compatibility::rawsetp(luaState, -2, convertibleTypeKey);
+                    // stack: metatable | metatableConversionPaths
+                    lua_pop(luaState, 1);
+                    // stack: metatable
+                }
+                lua_pop(luaState, 1);
+                // stack:
+            }
+
+            void clearConversionPathCache(lua_State *luaState) {
+                lua_pushnil(luaState);
+                // stack: nil
+                lua_compatibility::rawsetp(luaState, LUA_REGISTRYINDEX, TypeKey<ConversionPathCache>::get());
+                // stack:
+                // InlineCache entries are conversions too
+                InlineCache::invalidate();
+            }
+
+            void * applyConversionPathFunctions(lua_State *luaState, int index, bool &isConstantOffset) {
+                index = lua_compatibility::absindex(luaState, index);
+                // stack: conversionPath
+                if (lua_getmetatable(luaState, index) == 0) {
+                    // stack: conversionPath
+                    throw UnexpectedStackException(luaState, __FILE__, __LINE__, __func__, "expected userdata with metatable");
+                }
+                // stack: conversionPath | metatable
+                if (pushUnderlyingTypeLightUserData(luaState, index) == false) {
+                    // stack: conversionPath
+                    throw UnexpectedStackException(luaState, __FILE__, __LINE__, __func__, "corrupted UnderlyingTypeFunction");
+                }
+                // stack: conversionPath | underlyingLightUserData
+                const auto pathLength = lua_compatibility::rawlen(luaState, -2);
+                for (std::size_t i = 1; i <= pathLength; ++i) {
+                    // stack: conversionPath | lightUserData
+                    lua_rawgeti(luaState, -2, static_cast<lua_Integer>(i));
+                    // stack: conversionPath | lightUserData | function (?)
+                    if (lua_iscfunction(luaState, -1) == 0) {
+                        // stack: conversionPath | lightUserData | ?
+                        throw UnexpectedStackException(luaState, __FILE__, __LINE__, __func__, "corrupted conversionPath: expected cfunction at index -1");
+                    }
+                    // stack: conversionPath | lightUserData | function
+                    if (checkConstantOffsetTypeFunction(luaState) == false) {
+                        isConstantOffset = false;
+                    }
+                    lua_insert(luaState, -2);
+                    // stack: conversionPath | function | lightUserData
+                    lua_call(luaState, 1, 1);
+                    // stack: conversionPath | convertedLightUserData (?)
+                    if (lua_islightuserdata(luaState, -1) == 0) {
+                        // stack: conversionPath | ?
+                        throw UnexpectedStackException(luaState, __FILE__, __LINE__, __func__, "corrupted TypeFunction: expected convertedLightUserData at index -1");
+                    }
+                }
+                // stack: conversionPath | convertedLightUserData
+                // Attention! light userdata does not require alignment ajustment with basic::getAlignedObjectPointer
+                void * const object = lua_touserdata(luaState, -1);
+                lua_pop(luaState, 1);
+                // stack: conversionPath
+                return object;
+            }
+
+            void * getConvertibleTypePointer(lua_State *luaState, int index, const void *convertibleTypeKey, bool &isConstantOffset) {
+                isConstantOffset = true;
+                index = lua_compatibility::absindex(luaState, index);
+                if (lua_getmetatable(luaState, index) == 0) {
+                    return nullptr;
+                }
+                // stack: metatable
+                pushConversionPath(luaState, convertibleTypeKey);
+                // stack: metatable | [native]conversionPath or false
+                void *object = nullptr;
+                if (lua_isuserdata(luaState, -1) != 0) {
+                    // stack: metatable | nativeConversionPath
+                    // the conversion path is kept on the stack: the conversion (custom type function) might clear the cache
+                    const ConversionPath &conversionPath = *basic::getAlignedObjectPointer<ConversionPath>(luaState, -1);
+                    isConstantOffset = conversionPath.isConstantOffset();
+                    object = conversionPath.convert(lua_touserdata(luaState, index));
+                } else if (lua_istable(luaState, -1) != 0) {
+                    // stack: metatable | conversionPath
+                    object = applyConversionPathFunctions(luaState, index, isConstantOffset);
                 }
+                // stack: metatable | [native]conversionPath or false
+                lua_pop(luaState, 2);
+                // stack:
+                return object;
             }
 
             UserDataWrapperBase * getUserDataWrapperBase(lua_State *luaState, int index) {
@@ -551,13 +637,12 @@ namespace integral {
                     // stack: userdata (?) | metatable | userDataWrapperBaseTable (?)
                     if (lua_istable(luaState, -1) != 0) {
                         // stack: userdata (?) | metatable | userDataWrapperBaseTable
-                        lua_rawgeti(luaState, -1, static_cast<lua_Integer>(UserDataWrapperBaseTable::kTypeIndexIndex));
-                        // stack: userdata (?) | metatable | userDataWrapperBaseTable | userDataWrapperBaseTypeIndex (?)
-                        const std::type_index *typeIndex = basic::getAlignedObjectPointer<std::type_index>(luaState, -1, gkTypeIndexMetatableName);
-                        if (typeIndex != nullptr) {
-                            // stack: userdata (?) | metatable | userDataWrapperBaseTable | userDataWrapperBaseTypeIndex
-                            if (*typeIndex == std::type_index(typeid(UserDataWrapperBase))) {
-                                // stack: userdata (?) | metatable | userDataWrapperBaseTable | userDataWrapperBaseTypeIndex
+                        lua_rawgeti(luaState, -1, static_cast<lua_Integer>(UserDataWrapperBaseTable::kTypeKeyIndex));
+                        // stack: userdata (?) | metatable | userDataWrapperBaseTable | userDataWrapperBaseTypeKey (?)
+                        if (lua_islightuserdata(luaState, -1) != 0) {
+                            // stack: userdata (?) | metatable | userDataWrapperBaseTable | userDataWrapperBaseTypeKey
+                            if (lua_touserdata(luaState, -1) == TypeKey<UserDataWrapperBase>::get()) {
+                                // stack: userdata (?) | metatable | userDataWrapperBaseTable | userDataWrapperBaseTypeKey
                                 lua_pop(luaState, 1);
                                 // stack: userdata (?) | metatable | userDataWrapperBaseTable
                                 lua_rawgeti(luaState, -1, static_cast<lua_Integer>(UserDataWrapperBaseTable::kFunctionIndex));
@@ -589,7 +674,7 @@ namespace integral {
                                     throw UnexpectedStackException(luaState, __FILE__, __LINE__, __func__, "corrupted userDataWrapperBaseTable: expected cfunction at index -1");
                                 }
                             } else {
-                                // stack: userdata (?) | metatable | userDataWrapperBaseTable | ? (wrongTypeIndex - incompatible integral library?)
+                                // stack: userdata (?) | metatable | userDataWrapperBaseTable | ? (wrongTypeKey - incompatible integral library?)
                                 lua_pop(luaState, 4);
                             }
                         } else {
@@ -770,6 +855,269 @@ namespace integral {
                     // stack: metatable
                 }
             }
+
+            bool checkFlattenableKey(lua_State *luaState, int index) {
+                switch (lua_type(luaState, index)) {
+                    case LUA_TSTRING: {
+                        const char * const key = lua_tostring(luaState, index);
+                        return std::strncmp(key, "__", 2) != 0 && std::strncmp(key, "integral_", 9) != 0;
+                    }
+                    case LUA_TLIGHTUSERDATA:
+                        return lua_touserdata(luaState, index) != TypeKey<FlattenedDerived>::get();
+                    default:
+                        return true;
+                }
+            }
+
+            // not allowed to throw exception (this function is used in callFlattenedNewIndexMetamethod)
+            void setFlattenedField(lua_State *luaState, lua_Integer inheritanceIndex) {
+                const int metatableIndex = lua_gettop(luaState) - 2;
+                const int keyIndex = metatableIndex + 1;
+                const int valueIndex = metatableIndex + 2;
+                // stack: metatable | key | value
+                lua_pushstring(luaState, gkFlattenedFieldsKey);
+                // stack: metatable | key | value | gkFlattenedFieldsKey
+                lua_rawget(luaState, metatableIndex);
+                // stack: metatable | key | value | flattenedFields (?)
+                if (lua_istable(luaState, -1) == 0) {
+                    // stack: metatable | key | value | nil (?)
+                    lua_pop(luaState, 1);
+                    // stack: metatable | key | value
+                    lua_newtable(luaState);
+                    // stack: metatable | key | value | flattenedFields*
+                    lua_pushstring(luaState, gkFlattenedFieldsKey);
+                    // stack: metatable | key | value | flattenedFields* | gkFlattenedFieldsKey
+                    lua_pushvalue(luaState, -2);
+                    // stack: metatable | key | value | flattenedFields* | gkFlattenedFieldsKey | flattenedFields*
+                    lua_rawset(luaState, metatableIndex);
+                }
+                // stack: metatable | key | value | flattenedFields
+                lua_pushvalue(luaState, keyIndex);
+                // stack: metatable | key | value | flattenedFields | key
+                lua_rawget(luaState, -2);
+                // stack: metatable | key | value | flattenedFields | flattenedField (?)
+                lua_pushvalue(luaState, keyIndex);
+                // stack: metatable | key | value | flattenedFields | flattenedField (?) | key
+                lua_rawget(luaState, metatableIndex);
+                // stack: metatable | key | value | flattenedFields | flattenedField (?) | currentValue (?)
+                bool isSettable = false;
+                if (lua_isnil(luaState, -1) != 0) {
+                    isSettable = true;
+                } else if (lua_istable(luaState, -2) != 0) {
+                    // stack: metatable | key | value | flattenedFields | flattenedField | currentValue
+                    lua_rawgeti(luaState, -2, static_cast<lua_Integer>(FlattenedField::kValueIndex));
+                    // stack: metatable | key | value | flattenedFields | flattenedField | currentValue | flattenedValue
+                    lua_rawgeti(luaState, -3, static_cast<lua_Integer>(FlattenedField::kInheritanceIndexIndex));
+                    // stack: metatable | key | value | flattenedFields | flattenedField | currentValue | flattenedValue | flattenedInheritanceIndex
+                    // own fields (currentValue is not the copied value) are never overridden; fields from earlier defined base classes are
+                    isSettable = lua_rawequal(luaState, -2, -3) != 0 && inheritanceIndex >= lua_tointeger(luaState, -1);
+                    lua_pop(luaState, 2);
+                }
+                // stack: metatable | key | value | flattenedFields | flattenedField (?) | currentValue (?)
+                lua_pop(luaState, 2);
+                // stack: metatable | key | value | flattenedFields
+                if (isSettable == true) {
+                    lua_pushvalue(luaState, keyIndex);
+                    // stack: metatable | key | value | flattenedFields | key
+                    if (lua_isnil(luaState, valueIndex) != 0) {
+                        lua_pushnil(luaState);
+                    } else {
+                        lua_createtable(luaState, 2, 0);
+                        // stack: metatable | key | value | flattenedFields | key | flattenedField*
+                        lua_pushinteger(luaState, inheritanceIndex);
+                        // stack: metatable | key | value | flattenedFields | key | flattenedField* | inheritanceIndex
+                        lua_rawseti(luaState, -2, static_cast<lua_Integer>(FlattenedField::kInheritanceIndexIndex));
+                        // stack: metatable | key | value | flattenedFields | key | flattenedField*
+                        lua_pushvalue(luaState, valueIndex);
+                        // stack: metatable | key | value | flattenedFields | key | flattenedField* | value
+                        lua_rawseti(luaState, -2, static_cast<lua_Integer>(FlattenedField::kValueIndex));
+                    }
+                    // stack: metatable | key | value | flattenedFields | key | flattenedField* or nil
+                    lua_rawset(luaState, -3);
+                    // stack: metatable | key | value | flattenedFields
+                    lua_pop(luaState, 1);
+                    // stack: metatable | key | value
+                    lua_pushvalue(luaState, keyIndex);
+                    // stack: metatable | key | value | key
+                    lua_pushvalue(luaState, valueIndex);
+                    // stack: metatable | key | value | key | value
+                    lua_rawset(luaState, metatableIndex);
+                    // stack: metatable | key | value
+                    propagateFlattenedField(luaState);
+                    // stack: metatable
+                } else {
+                    // stack: metatable | key | value | flattenedFields
+                    lua_settop(luaState, metatableIndex);
+                    // stack: metatable
+                }
+            }
+
+            // not allowed to throw exception (this function is used in callFlattenedNewIndexMetamethod)
+            void propagateFlattenedField(lua_State *luaState) {
+                const int metatableIndex = lua_gettop(luaState) - 2;
+                // stack: metatable | key | value
+                lua_compatibility::rawgetp(luaState, metatableIndex, TypeKey<FlattenedDerived>::get());
+                // stack: metatable | key | value | flattenedDerived (?)
+                if (lua_istable(luaState, -1) != 0 && checkFlattenableKey(luaState, metatableIndex + 1) == true && checkInheritanceSearchTag(luaState, metatableIndex) == false) {
+                    // stack: metatable | key | value | flattenedDerived
+                    tagInheritanceSearch(luaState, metatableIndex);
+                    lua_pushnil(luaState);
+                    // stack: metatable | key | value | flattenedDerived | nil
+                    for (int hasNext = lua_next(luaState, -2); hasNext != 0; hasNext = lua_next(luaState, -2)) {
+                        // stack: metatable | key | value | flattenedDerived | derivedMetatable | inheritanceIndex
+                        const lua_Integer inheritanceIndex = lua_tointeger(luaState, -1);
+                        lua_pop(luaState, 1);
+                        // stack: metatable | key | value | flattenedDerived | derivedMetatable
+                        lua_pushvalue(luaState, -1);
+                        // stack: metatable | key | value | flattenedDerived | derivedMetatable | derivedMetatable
+                        lua_pushvalue(luaState, metatableIndex + 1);
+                        // stack: metatable | key | value | flattenedDerived | derivedMetatable | derivedMetatable | key
+                        lua_pushvalue(luaState, metatableIndex + 2);
+                        // stack: metatable | key | value | flattenedDerived | derivedMetatable | derivedMetatable | key | value
+                        setFlattenedField(luaState, inheritanceIndex);
+                        // stack: metatable | key | value | flattenedDerived | derivedMetatable | derivedMetatable
+                        lua_pop(luaState, 1);
+                        // stack: metatable | key | value | flattenedDerived | derivedMetatable
+                    }
+                    // stack: metatable | key | value | flattenedDerived
+                    untagInheritanceSearch(luaState, metatableIndex);
+                }
+                lua_settop(luaState, metatableIndex);
+                // stack: metatable
+            }
+
+            // not allowed to throw exception (this function is used in callFlattenedNewIndexMetamethod)
+            void rawsetWithFlattenedInheritance(lua_State *luaState) {
+                // stack: table | key | value
+                lua_pushvalue(luaState, -2);
+                // stack: table | key | value | key
+                lua_pushvalue(luaState, -2);
+                // stack: table | key | value | key | value
+                lua_rawset(luaState, -5);
+                // stack: table | key | value
+                propagateFlattenedField(luaState);
+                // stack: table
+            }
+
+            // lua_CFunction style function: no exceptions and no objects (with destructors)
+            // noexcept specifier is not used because if lua is compiled as c++, some of its functions might throw an exception
+            int callFlattenedNewIndexMetamethod(lua_State *luaState) {
+                // arguments: table (1), key (2), value (3)
+                lua_settop(luaState, 3);
+                // stack: table | key | value
+                rawsetWithFlattenedInheritance(luaState);
+                // stack: table
+                return 0;
+            }
+
+            void setFlattenedNewIndexMetatable(lua_State *luaState) {
+                // stack: metatable
+                if (lua_getmetatable(luaState, -1) == 0) {
+                    // stack: metatable
+                    lua_createtable(luaState, 0, 1);
+                    // stack: metatable | metatableMetatable*
+                    lua_pushstring(luaState, "__newindex");
+                    // stack: metatable | metatableMetatable* | "__newindex"
+                    lua_pushcfunction(luaState, callFlattenedNewIndexMetamethod);
+                    // stack: metatable | metatableMetatable* | "__newindex" | callFlattenedNewIndexMetamethod
+                    lua_rawset(luaState, -3);
+                    // stack: metatable | metatableMetatable*
+                    lua_setmetatable(luaState, -2);
+                    // stack: metatable
+                } else { // preserves a previously defined metatable (possibly with other metamethods)
+                    // stack: metatable | metatableMetatable
+                    lua_pushstring(luaState, "__newindex");
+                    // stack: metatable | metatableMetatable | "__newindex"
+                    lua_pushcfunction(luaState, callFlattenedNewIndexMetamethod);
+                    // stack: metatable | metatableMetatable | "__newindex" | callFlattenedNewIndexMetamethod
+                    lua_rawset(luaState, -3);
+                    // stack: metatable | metatableMetatable
+                    lua_pop(luaState, 1);
+                    // stack: metatable
+                }
+            }
+
+            void flattenInheritance(lua_State *luaState) {
+                const int metatableIndex = lua_gettop(luaState) - 1;
+                const int baseMetatableIndex = metatableIndex + 1;
+                // stack: metatable | baseMetatable
+                lua_pushstring(luaState, gkInheritanceKey);
+                // stack: metatable | baseMetatable | gkInheritanceKey
+                lua_rawget(luaState, metatableIndex);
+                // stack: metatable | baseMetatable | inheritanceTable (?)
+                lua_Integer inheritanceIndex = 0;
+                if (lua_istable(luaState, -1) != 0) {
+                    // stack: metatable | baseMetatable | inheritanceTable
+                    const auto inheritanceTableLength = lua_compatibility::rawlen(luaState, -1);
+                    for (std::size_t i = 1; i <= inheritanceTableLength; ++i) {
+                        lua_rawgeti(luaState, -1, static_cast<lua_Integer>(i));
+                        // stack: metatable | baseMetatable | inheritanceTable | baseTable (?)
+                        if (lua_istable(luaState, -1) == 0) {
+                            // stack: metatable | baseMetatable | inheritanceTable | ?
+                            throw UnexpectedStackException(luaState, __FILE__, __LINE__, __func__, "corrupted inheritanceTable: expected baseTable at index -1");
+                        }
+                        // stack: metatable | baseMetatable | inheritanceTable | baseTable
+                        lua_rawgeti(luaState, -1, static_cast<lua_Integer>(InheritanceTable::kMetatableIndex));
+                        // stack: metatable | baseMetatable | inheritanceTable | baseTable | baseTableMetatable (?)
+                        if (lua_rawequal(luaState, -1, baseMetatableIndex) != 0) {
+                            inheritanceIndex = static_cast<lua_Integer>(i);
+                        }
+                        lua_pop(luaState, 2);
+                        // stack: metatable | baseMetatable | inheritanceTable
+                    }
+                }
+                // stack: metatable | baseMetatable | inheritanceTable (?)
+                lua_pop(luaState, 1);
+                // stack: metatable | baseMetatable
+                if (inheritanceIndex == 0) {
+                    throw UnexpectedStackException(luaState, __FILE__, __LINE__, __func__, "flattened inheritance: baseMetatable is not in inheritanceTable");
+                }
+                lua_compatibility::rawgetp(luaState, baseMetatableIndex, TypeKey<FlattenedDerived>::get());
+                // stack: metatable | baseMetatable | flattenedDerived (?)
+                if (lua_istable(luaState, -1) == 0) {
+                    // stack: metatable | baseMetatable | nil (?)
+                    lua_pop(luaState, 1);
+                    // stack: metatable | baseMetatable
+                    lua_newtable(luaState);
+                    // stack: metatable | baseMetatable | flattenedDerived*
+                    lua_pushvalue(luaState, -1);
+                    // stack: metatable | baseMetatable | flattenedDerived* | flattenedDerived*
+                    lua_compatibility::rawsetp(luaState, baseMetatableIndex, TypeKey<FlattenedDerived>::get());
+                }
+                // stack: metatable | baseMetatable | flattenedDerived
+                lua_pushvalue(luaState, metatableIndex);
+                // stack: metatable | baseMetatable | flattenedDerived | metatable
+                lua_pushinteger(luaState, inheritanceIndex);
+                // stack: metatable | baseMetatable | flattenedDerived | metatable | inheritanceIndex
+                lua_rawset(luaState, -3);
+                // stack: metatable | baseMetatable | flattenedDerived
+                lua_pop(luaState, 1);
+                // stack: metatable | baseMetatable
+                setFlattenedNewIndexMetatable(luaState);
+                // stack: metatable | baseMetatable
+                lua_pushnil(luaState);
+                // stack: metatable | baseMetatable | nil
+                for (int hasNext = lua_next(luaState, baseMetatableIndex); hasNext != 0; hasNext = lua_next(luaState, baseMetatableIndex)) {
+                    // stack: metatable | baseMetatable | key | value
+                    if (checkFlattenableKey(luaState, -2) == true) {
+                        lua_pushvalue(luaState, metatableIndex);
+                        // stack: metatable | baseMetatable | key | value | metatable
+                        lua_pushvalue(luaState, -3);
+                        // stack: metatable | baseMetatable | key | value | metatable | key
+                        lua_pushvalue(luaState, -3);
+                        // stack: metatable | baseMetatable | key | value | metatable | key | value
+                        setFlattenedField(luaState, inheritanceIndex);
+                        // stack: metatable | baseMetatable | key | value | metatable
+                        lua_pop(luaState, 1);
+                    }
+                    // stack: metatable | baseMetatable | key | value
+                    lua_pop(luaState, 1);
+                    // stack: metatable | baseMetatable | key
+                }
+                // stack: metatable | baseMetatable
+                lua_pop(luaState, 1);
+                // stack: metatable
+            }
         }
     }
 }
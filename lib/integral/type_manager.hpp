@@ -30,7 +30,6 @@
 #include <cstddef>
 #include <functional>
 #include <string>
-#include <typeindex>
 #include <type_traits>
 #include <utility>
 #include <lua.hpp>
@@ -38,89 +37,121 @@
 #include "ConversionFunctionTraits.hpp"
 #include "FunctionTraits.hpp"
 #include "lua_compatibility.hpp"
+#include "TypeFunction.hpp"
+#include "TypeKey.hpp"
 #include "UnexpectedStackException.hpp"
 #include "UserDataWrapper.hpp"
 
 // typeid(T).name() cannot be used as an automatic indentifier for metatables. It is not safe: different classes might have the same typeid(T).name() (c++ standard)
-// std::type_index is used as an automatic indentifier for metatables. Supposedly, it is safe.
+// TypeKey<T>::get() (lightuserdata) is used as an automatic indentifier for metatables: identity checks are pointer comparisons and RTTI is not required
+// Attention! TypeKey<T>::get() must be unique across every module (executable and shared libraries) using the same lua_State. This holds for default symbol visibility (ELF), but not for Windows DLLs or -fvisibility=hidden: each module would have its own class metatables
 
-// TypeManager organization (hashmap):
-// REGISTRY[gkTypeManagerRegistryKey] = {[typeHash] = {[type_index_udata] = rootMetatable}}
-// REGISTRY[gkTypeManagerRegistryKey] = {[typeHash] = typeHashBucket}
+// TypeManager organization:
+// REGISTRY[gkTypeManagerRegistryKey] = {[typeKey] = rootMetatable}
 // REGISTRY[gkTypeManagerRegistryKey] = typeManager
 
+// TypeManager cache (one raw lookup):
+// REGISTRY[TypeKey<UserDataType<T>>::get()] = rootMetatable
+// it is filled the first time the root metatable is pushed. TypeManager is the fallback
+
+// Conversion path cache (lightuserdata keys):
+// REGISTRY[TypeKey<ConversionPathCache>::get()] = {[metatable] = {[TypeKey<T>::get()] = {typeFunction1, typeFunction2, ...} or false}}
+// REGISTRY[TypeKey<ConversionPathCache>::get()] = {[metatable] = metatableConversionPaths}
+// REGISTRY[TypeKey<ConversionPathCache>::get()] = conversionPathCache (weak keys)
+// typeFunctions are applied (in order) to the underlying type lightuserdata; false is a cached failed search
+// if every type function (and the underlying type function) is a native TypeFunction closure, the conversion path table is replaced by a ConversionPath userdata (no Lua calls)
+// a successful dynamic_cast fallback (exchanger) is memoized as a constant offset ConversionPath userdata (the dynamic type of a userdata is fixed by its metatable)
+// it is cleared (together with every InlineCache) whenever a type function or an inheritance is set
+
+// Flattened inheritance (opt-in):
+// derivedMetatable[gkFlattenedFieldsKey] = {[key] = {inheritanceIndex, value}} (fields copied from base class metatables; a field whose current value differs from the copied one is an own field)
+// baseMetatable[TypeKey<FlattenedDerived>::get()] = {[derivedMetatable] = inheritanceIndex} (lightuserdata key: no string hashing on propagation)
+// inheritanceIndex is the index of baseMetatable in derivedMetatable[gkInheritanceKey]
+
 // TypeManager (integral) version control:
 // REGISTRY[gkTypeManagerRegistryKey][gkTypeManagerVersionKey] = TYPE_MANAGER_VERSION
 
-// there might be clashes with typeHash. It is NOT a problem. TypeManager is implemented as a hashmap.
-
-// Attention! The stored type_index (type_index_udata) is from std::type_index(typeid(UserDataWrapper<T>))
+// Attention! The stored class metatable typeKey is TypeKey<UserDataType<T>>::get()
 // This is useful when multiple integral versions are used.
 // Maybe UserDataWrapper<T> is incompatible from different integral versions used together; this way, it will fail gracefully.
+// Compact types (CompactUserData<T>): the stored class metatable typeKey is TypeKey<T>::get(). Their root metatable has no __gc and no gkUserDataWrapperBaseTableKey
+// Registry and metatable field names differ from the ones of previous (std::type_index based) versions, so that they can be used together.
 
 namespace integral {
     namespace detail {
         namespace type_manager {
             extern const char * const gkTypeManagerRegistryKey;
-            extern const char * const gkTypeIndexKey;
+            extern const char * const gkTypeKeyKey;
             extern const char * const gkTypeManagerVersionKey;
             extern const char * const gkTypeManagerVersion;
-            extern const char * const gkTypeIndexMetatableName;
             extern const char * const gkTypeFunctionsKey;
             extern const char * const gkUserDataWrapperBaseTableKey;
             extern const char * const gkUnderlyingTypeFunctionKey;
+            extern const char * const gkUserDataWrapperAlignmentKey;
             extern const char * const gkInheritanceSearchTagKey;
             extern const char * const gkInheritanceKey;
             extern const char * const gkInheritanceIndexMetamethodKey;
+            extern const char * const gkFlattenedFieldsKey;
+
+            // conversion path cache registry key tag (see TypeKey)
+            class ConversionPathCache;
+
+            // flattened derived class metatables key tag (see TypeKey)
+            class FlattenedDerived;
 
             enum class InheritanceTable : int {
-                kTypeIndexIndex = 1,
+                kTypeKeyIndex = 1,
                 kMetatableIndex = 2
             };
 
+            enum class FlattenedField : int {
+                kInheritanceIndexIndex = 1,
+                kValueIndex = 2
+            };
+
             enum class UserDataWrapperBaseTable : int {
-                kTypeIndexIndex = 1,
+                kTypeKeyIndex = 1,
                 kFunctionIndex = 2
             };
 
             // stack argument: metatable
-            const std::type_index * getClassMetatableType(lua_State *luaState);
+            // returns nullptr if metatable is not a class metatable
+            const void * getClassMetatableType(lua_State *luaState);
 
             // stack argument: metatable
-            bool checkClassMetatableType(lua_State *luaState, const std::type_index &typeIndex);
+            bool checkClassMetatableType(lua_State *luaState, const void *typeKey);
 
-            // typeIndex is the class metatable type (typeIndex = std::type_index(typeid(UserDataWrapper<T>)))
-            bool checkClassMetatableExistence(lua_State *luaState, const std::type_index &typeIndex);
+            // typeKey is the class metatable type (typeKey = TypeKey<UserDataType<T>>::get())
+            bool checkClassMetatableExistence(lua_State *luaState, const void *typeKey);
 
             // T is the underlying type
             template<typename T>
             inline bool checkClassMetatableExistence(lua_State *luaState);
 
+            // returns UserDataWrapper<T> or T (compact types) pointer
             template<typename T>
-            UserDataWrapper<T> * getUserDataWrapper(lua_State *luaState, int index);
-
-            template<typename T>
-            void pushRootMetatableFromTypeHashBucketTable(lua_State *luaState, const std::type_index &typeIndex);
+            UserDataType<T> * getUserDataWrapper(lua_State *luaState, int index);
 
             // stack argument: typeManager
             // returns rootMetatable
             // pops typemanager from stack
             template<typename T>
-            void pushRootMetatableFromTypeManager(lua_State *luaState, const std::type_index &typeIndex, std::size_t typeHash);
+            void pushRootMetatableFromTypeManager(lua_State *luaState);
 
+            // searches (or creates) the root metatable in TypeManager
+            // returns true if the metatable was created
             template<typename T>
-            bool pushClassMetatable(lua_State *luaState);
-
-            void pushTypeIndexUserData(lua_State *luaState, const std::type_index &typeIndex);
+            bool pushClassMetatableFromTypeManager(lua_State *luaState);
 
+            // uses TypeManager cache if possible
+            // returns true if the metatable was created
             template<typename T>
-            inline void pushTypeIndexUserData(lua_State *luaState);
-
-            void setTypeFunctionHashTable(lua_State *luaState, std::size_t baseTypeHash);
+            bool pushClassMetatable(lua_State *luaState);
 
             // stack argument: metatable
-            // this function should be used only for the creation of typeFunctionHashTable
-            void pushTypeFunctionHashTable(lua_State *luaState, const std::type_index &baseTypeIndex);
+            // pushes typeFunctionTable (it is created if necessary)
+            // this function should be used only for the creation of a type function (throws if the type function to baseTypeKey already exists)
+            void pushTypeFunctionTable(lua_State *luaState, const void *baseTypeKey);
 
             // stack argument: metatable
             template<typename D, typename B>
@@ -151,17 +182,70 @@ namespace integral {
             // index: metatable to be tagged
             void untagInheritanceSearch(lua_State *luaState, int index);
 
-            // index: userdata or lightuserdata of the underlying type of a userdata
+            // lua_CFunction of every type function closure (and underlying type function closure)
+            // up values: TypeFunction lightuserdata [, TypeFunction owner userdata]
+            // argument: underlying type lightuserdata (or userdata for the underlying type function)
+            int callTypeFunction(lua_State *luaState);
+
+            // stack argument (if hasOwner is true): typeFunction owner (userdata). It is popped from stack
+            // pushes callTypeFunction closure
+            void pushTypeFunctionClosure(lua_State *luaState, const TypeFunction &typeFunction, bool hasOwner);
+
+            // stack argument: typeFunction (closure)
+            // returns nullptr if typeFunction is not a callTypeFunction closure (e.g.: from a different integral version)
+            const TypeFunction * getNativeTypeFunction(lua_State *luaState);
+
+            // stack argument: typeFunction
+            // static_casts (setTypeFunction<D, B>) are constant pointer offsets for a given userdata type
+            // custom type functions (std::function) might not be
+            bool checkConstantOffsetTypeFunction(lua_State *luaState);
+
             // stack argument: metatable
-            // returns true if the convertible type is pushed onto the stack, and false otherwise
-            // metatable will be popped from stack in either case
-            bool pushDirectConvertibleType(lua_State *luaState, int index, const std::type_index &convertibleTypeIndex);
+            // returns true if the type function (metatable type -> typeKey) is pushed onto the stack, and false otherwise
+            // metatable is not popped from stack
+            bool pushTypeFunction(lua_State *luaState, const void *typeKey);
 
-            // index: userdata (recursion = false) or lightuserdata (recursion = true) of the underlying type of a userdata stack index
+            // depth-first search through type functions and inheritance (bases are searched from the last to the first defined one)
             // stack argument: metatable
-            // returns true if the convertible type is pushed onto the stack, and false otherwise
+            // pathIndex: conversion path table. The type functions of a successful search are appended to it
+            // returns true if a conversion path (metatable type -> convertibleTypeKey) is found, and false otherwise
             // metatable will be popped from stack in either case
-            bool pushConvertibleOrInheritedType(lua_State *luaState, int index, const std::type_index &convertibleTypeIndex, bool isRecursion);
+            bool searchConversionPath(lua_State *luaState, const void *convertibleTypeKey, int pathIndex);
+
+            // uses the conversion path cache (searchConversionPath is only called if there is no cached result)
+            // convertibleTypeKey: TypeKey<T>::get(). It is also the conversion path cache key
+            // stack argument: metatable
+            // pushes the conversion path or false (failed search)
+            // metatable is not popped from stack
+            void pushConversionPath(lua_State *luaState, const void *convertibleTypeKey);
+
+            // stack argument: conversionPath (table)
+            // metatableIndex: source metatable
+            // replaces conversionPath with a ConversionPath userdata if every type function is native (see getNativeTypeFunction)
+            void setNativeConversionPath(lua_State *luaState, int metatableIndex);
+
+            // stack argument: metatable
+            // pushes the metatable conversion paths table from the conversion path cache (it is created if necessary)
+            // metatable is not popped from stack
+            void pushMetatableConversionPaths(lua_State *luaState);
+
+            // index: userdata
+            // object: convertible type (convertibleTypeKey) pointer of userdata obtained outside of the type manager (dynamic_cast)
+            // caches the conversion as a constant offset ConversionPath. Nothing is cached if the userdata underlying type function is not native
+            void setConstantOffsetConversionPath(lua_State *luaState, int index, const void *convertibleTypeKey, void *object);
+
+            void clearConversionPathCache(lua_State *luaState);
+
+            // index: userdata
+            // stack argument: conversionPath (table). It is not popped from stack
+            // applies the conversion path type functions with Lua calls (used if some type function is not native)
+            // isConstantOffset is set to false if a custom type function is used
+            void * applyConversionPathFunctions(lua_State *luaState, int index, bool &isConstantOffset);
+
+            // index: userdata
+            // returns nullptr if there is no conversion
+            // isConstantOffset is set to false if a custom type function is used
+            void * getConvertibleTypePointer(lua_State *luaState, int index, const void *convertibleTypeKey, bool &isConstantOffset);
 
             // stack argument: metatable
             template<typename T>
@@ -174,8 +258,12 @@ namespace integral {
             // metatable will be popped from stack in either case
             bool pushUnderlyingTypeLightUserData(lua_State *luaState, int index);
 
+            // isConstantOffset: whether the conversion (if successful) is a constant pointer offset for the userdata type (see checkConstantOffsetTypeFunction)
+            template<typename T>
+            inline T * getConvertibleType(lua_State *luaState, int index, bool &isConstantOffset);
+
             template<typename T>
-            T * getConvertibleType(lua_State *luaState, int index);
+            inline T * getConvertibleType(lua_State *luaState, int index);
 
             // stack argument: metatable
             template<typename D, typename B>
@@ -192,8 +280,8 @@ namespace integral {
             void defineInheritance(lua_State *luaState, F &&typeFunction);
 
             // stack argument: inheritanceTable
-            // returns true if inheritanceTable has typeIndex
-            bool checkInheritanceTable(lua_State *luaState, const std::type_index &typeIndex);
+            // returns true if inheritanceTable has typeKey
+            bool checkInheritanceTable(lua_State *luaState, const void *typeKey);
 
             // stack argument: metatable
             template<typename B>
@@ -206,20 +294,87 @@ namespace integral {
             // stack argument: metatable
             void setInheritanceIndexMetatable(lua_State *luaState);
 
+            // stack argument: metatable
+            // copies base class metatable (B) fields into metatable. Later changes to base class metatable fields are propagated (see rawsetWithFlattenedInheritance)
+            template<typename D, typename B>
+            void setFlattenedInheritance(lua_State *luaState);
+
+            // stack argument: metatable
+            template<typename F>
+            void setFlattenedInheritance(lua_State *luaState, F &&typeFunction);
+
+            template<typename D, typename B>
+            void defineFlattenedInheritance(lua_State *luaState);
+
+            template<typename F>
+            void defineFlattenedInheritance(lua_State *luaState, F &&typeFunction);
+
+            // index: key
+            // metamethods ("__*") and integral fields ("integral_*") are not flattened
+            bool checkFlattenableKey(lua_State *luaState, int index);
+
+            // stack argument: metatable | key | value
+            // sets a base class metatable field in (derived) metatable unless it is overridden by a metatable own field or by a later defined base class (greater inheritanceIndex)
+            // propagates the field to metatable flattened derived class metatables
+            // key and value are popped from stack
+            void setFlattenedField(lua_State *luaState, lua_Integer inheritanceIndex);
+
+            // stack argument: metatable | key | value
+            // key and value are popped from stack
+            void propagateFlattenedField(lua_State *luaState);
+
+            // stack argument: table | key | value
+            // lua_rawset(luaState, -3) which also propagates the field to flattened derived class metatables (if table is a base class metatable)
+            // key and value are popped from stack
+            void rawsetWithFlattenedInheritance(lua_State *luaState);
+
+            // stack argument: table | key | value
+            // plain lua_rawset(luaState, -3) if table has no metatable (generic table writes, e.g. global variables); otherwise rawsetWithFlattenedInheritance (flattened base class metatables have a metatable: see setFlattenedNewIndexMetatable)
+            // key and value are popped from stack
+            inline void rawset(lua_State *luaState);
+
+            // lua_CFunction style function: __newindex metamethod of flattened base class metatable metatable (see rawsetWithFlattenedInheritance)
+            int callFlattenedNewIndexMetamethod(lua_State *luaState);
+
+            // stack argument: metatable (base class metatable)
+            void setFlattenedNewIndexMetatable(lua_State *luaState);
+
+            // stack argument: metatable | baseMetatable
+            // metatable must already inherit from baseMetatable (setInheritance)
+            // baseMetatable is popped from stack
+            void flattenInheritance(lua_State *luaState);
+
             //--
 
+            inline void rawset(lua_State *luaState) {
+                // stack: table | key | value
+                if (lua_getmetatable(luaState, -3) == 0) {
+                    lua_rawset(luaState, -3);
+                } else {
+                    // stack: table | key | value | tableMetatable
+                    lua_pop(luaState, 1);
+                    rawsetWithFlattenedInheritance(luaState);
+                }
+                // stack: table
+            }
+
             template<typename T>
             inline bool checkClassMetatableExistence(lua_State *luaState) {
-                return checkClassMetatableExistence(luaState, std::type_index(typeid(UserDataWrapper<T>)));
+                lua_compatibility::rawgetp(luaState, LUA_REGISTRYINDEX, TypeKey<UserDataType<T>>::get());
+                // stack: rootMetatable (?)
+                const bool isCached = lua_istable(luaState, -1) != 0;
+                lua_pop(luaState, 1);
+                // stack:
+                return isCached == true || checkClassMetatableExistence(luaState, TypeKey<UserDataType<T>>::get());
             }
 
             template<typename T>
-            UserDataWrapper<T> * getUserDataWrapper(lua_State *luaState, int index) {
-                UserDataWrapper<T> *userDataWrapperPointer = basic::getAlignedObjectPointer<UserDataWrapper<T>>(luaState, index);
+            UserDataType<T> * getUserDataWrapper(lua_State *luaState, int index) {
+                UserDataType<T> *userDataWrapperPointer = basic::getAlignedObjectPointer<UserDataType<T>>(luaState, index);
                 if (userDataWrapperPointer != nullptr) {
                     if (lua_getmetatable(luaState, index) != 0) {
                         //stack: metatable
-                        if (checkClassMetatableType(luaState, std::type_index(typeid(UserDataWrapper<T>))) == true) {
+                        if (checkClassMetatableType(luaState, TypeKey<UserDataType<T>>::get()) == true) {
                             lua_pop(luaState, 1);
                             return userDataWrapperPointer;
                         }
@@ -230,133 +385,84 @@ namespace integral {
             }
 
             template<typename T>
-            void pushRootMetatableFromTypeHashBucketTable(lua_State *luaState, const std::type_index &typeIndex) {
-                // stack: typeHashBucket
-                pushTypeIndexUserData(luaState, typeIndex);
-                // stack: typeHashBucket | type_index_udata*
+            void pushRootMetatableFromTypeManager(lua_State *luaState) {
+                static_assert(keIsCompactUserData<T> == false || std::is_trivially_destructible_v<T> == true, "compact userdata type must be trivially destructible");
+                // stack: typeManager
                 lua_newtable(luaState);
-                // stack: typeHashBucket | type_index_udata* | rootMetatable*
+                // stack: typeManager | rootMetatable*
                 lua_pushstring(luaState, "__index");
-                // stack: typeHashBucket | type_index_udata* | rootMetatable* | "__index"
+                // stack: typeManager | rootMetatable* | "__index"
                 lua_pushvalue(luaState, -2); // duplicates the metatable
-                // stack: typeHashBucket | type_index_udata* | rootMetatable* | "__index" | rootMetatable*
+                // stack: typeManager | rootMetatable* | "__index" | rootMetatable*
                 lua_rawset(luaState, -3); // metatable.__index = metatable
-                // stack: typeHashBucket | type_index_udata* | rootMetatable*
-                basic::setLuaFunction(luaState, "__gc", [](lua_State *lambdaLuaState) -> int {
-                    basic::getAlignedObjectPointer<UserDataWrapper<T>>(lambdaLuaState, 1)->~UserDataWrapper<T>();
-                    return 0;
-                }, 0);
-                // stack: typeHashBucket | type_index_udata* | rootMetatable*
-                lua_pushstring(luaState, gkTypeIndexKey);
-                // stack: typeHashBucket | type_index_udata* | rootMetatable* | gkTypeIndexKey
-                lua_pushvalue(luaState, -3);
-                // stack: typeHashBucket | type_index_udata* | rootMetatable* | gkTypeIndexKey | type_index_udata*
+                // stack: typeManager | rootMetatable*
+                if constexpr (keIsCompactUserData<T> == false) {
+                    // compact userdata has no finalizer: it is not included in lua finalizer list
+                    basic::setLuaFunction(luaState, "__gc", [](lua_State *lambdaLuaState) -> int {
+                        basic::getAlignedObjectPointer<UserDataWrapper<T>>(lambdaLuaState, 1)->~UserDataWrapper<T>();
+                        return 0;
+                    }, 0);
+                }
+                // stack: typeManager | rootMetatable*
+                lua_pushstring(luaState, gkTypeKeyKey);
+                // stack: typeManager | rootMetatable* | gkTypeKeyKey
+                lua_pushlightuserdata(luaState, TypeKey<UserDataType<T>>::get());
+                // stack: typeManager | rootMetatable* | gkTypeKeyKey | typeKey
                 lua_rawset(luaState, -3); // used for getUserDataWrapper
-                // stack: typeHashBucket | type_index_udata* | rootMetatable*
+                // stack: typeManager | rootMetatable*
                 lua_pushvalue(luaState, -1);
-                // stack: typeHashBucket | type_index_udata* | rootMetatable* | rootMetatable*
-                lua_insert(luaState, -4);
-                // stack: rootMetatable* | typeHashBucket | type_index_udata* | rootMetatable*
-                lua_rawset(luaState, -3);
-                // stack: rootMetatable | typeHashBucket
-                lua_pop(luaState, 1);
+                // stack: typeManager | rootMetatable* | rootMetatable*
+                lua_compatibility::rawsetp(luaState, -3, TypeKey<UserDataType<T>>::get());
+                // stack: typeManager | rootMetatable
+                lua_remove(luaState, -2);
                 // stack: rootMetatable
-                setUserDataWrapperBaseTable<T>(luaState);
+                if constexpr (keIsCompactUserData<T> == false) {
+                    setUserDataWrapperBaseTable<T>(luaState);
+                }
                 // stack: rootMetatable
-                // Underlying type pointer conversion function
-                basic::setLuaFunction(luaState, gkUnderlyingTypeFunctionKey, [](lua_State *lambdaLuaState) -> int {
-                    lua_pushlightuserdata(
-                        lambdaLuaState,
-                        static_cast<void *>(
-                            static_cast<T *>(
-                                basic::getAlignedObjectPointer<UserDataWrapper<T>>(lambdaLuaState, 1)
-                            )
-                        )
-                    );
-                    return 1;
-                }, 0);
+                lua_pushstring(luaState, gkUserDataWrapperAlignmentKey);
+                // stack: rootMetatable | gkUserDataWrapperAlignmentKey
+                lua_compatibility::pushunsigned(luaState, alignof(UserDataType<T>));
+                // stack: rootMetatable | gkUserDataWrapperAlignmentKey | alignment
+                lua_rawset(luaState, -3); // used for InlineCache
                 // stack: rootMetatable
-            }
-
-            template<typename T>
-            void pushRootMetatableFromTypeManager(lua_State *luaState, const std::type_index &typeIndex, std::size_t typeHash) {
-                // stack: typeManager
-                static_assert(sizeof(typeHash) <= sizeof(lua_Integer), "lua_Integer cannot accommodate typeHash");
-                lua_pushinteger(luaState, static_cast<lua_Integer>(typeHash));
-                // stack: typeManager | typeHash
-                lua_newtable(luaState);
-                // stack: typeManager | typeHash | typeHashBucket*
-                lua_pushvalue(luaState, -1);
-                // stack: typeManager | typeHash | typeHashBucket* | typeHashBucket*
-                lua_insert(luaState, -4);
-                // stack: typeHashBucket* | typeManager | typeHash | typeHashBucket*
+                // Underlying type pointer conversion function
+                lua_pushstring(luaState, gkUnderlyingTypeFunctionKey);
+                // stack: rootMetatable | gkUnderlyingTypeFunctionKey
+                pushTypeFunctionClosure(luaState, UnderlyingTypeFunction<T>::keTypeFunction, false);
+                // stack: rootMetatable | gkUnderlyingTypeFunctionKey | function*
                 lua_rawset(luaState, -3);
-                // stack: typeHashBucket | typeManager
-                lua_pop(luaState, 1);
-                // stack: typeHashBucket
-                pushRootMetatableFromTypeHashBucketTable<T>(luaState, typeIndex);
                 // stack: rootMetatable
             }
 
             template<typename T>
-            bool pushClassMetatable(lua_State *luaState) {
-                // Attention! The stored type_index is UserDataWrapper<T>
+            bool pushClassMetatableFromTypeManager(lua_State *luaState) {
+                // Attention! The stored typeKey is UserDataWrapper<T>
                 // This is useful when multiple integral versions are used.
                 // Maybe UserDataWrapper<T> is incompatible from different integral versions used together; this way, it will fail gracefully.
                 static_assert(std::is_same_v<std::decay_t<T>, std::string> == false, "cannot push std::string metatable. integral treats it as a primitive lua type");
-                const std::type_index typeIndex = typeid(UserDataWrapper<T>);
-                const std::size_t typeHash = typeIndex.hash_code();
                 lua_pushstring(luaState, gkTypeManagerRegistryKey);
                 // stack: gkTypeManagerRegistryKey
                 lua_rawget(luaState, LUA_REGISTRYINDEX);
                 // stack: typeManager (?)
                 if (lua_istable(luaState, -1) != 0) {
                     // stack: typeManager
-                    static_assert(sizeof(typeHash) <= sizeof(lua_Integer), "lua_Integer cannot accommodate typeHash");
-                    lua_pushinteger(luaState, static_cast<lua_Integer>(typeHash));
-                    // stack: typeManager | typeHash
-                    lua_rawget(luaState, -2);
-                    // stack: typeManager | typeHashBucket (?)
+                    lua_compatibility::rawgetp(luaState, -1, TypeKey<UserDataType<T>>::get());
+                    // stack: typeManager | rootMetatable (?)
                     if (lua_istable(luaState, -1) != 0) {
-                        // stack: typeManager | typeHashBucket
+                        // stack: typeManager | rootMetatable
                         lua_remove(luaState, -2);
-                        // stack: typeHashBucket
-                        lua_pushnil(luaState);
-                        // stack: typeHashBucket | nil
-                        for (int hasNext = lua_next(luaState, -2); hasNext != 0; lua_pop(luaState, 1), hasNext = lua_next(luaState, -2)) {
-                            std::type_index *storedTypeIndex = basic::getAlignedObjectPointer<std::type_index>(luaState, -2, gkTypeIndexMetatableName);
-                            // stack: typeHashBucket | type_index_udata (?) | rootMetatable (?)
-                            if (storedTypeIndex != nullptr) {
-                                // stack: typeHashBucket | type_index_udata | rootMetatable (?)
-                                if (*storedTypeIndex == typeIndex) {
-                                    lua_remove(luaState, -2);
-                                    // stack: typeHashBucket | rootMetatable (?)
-                                    if (lua_istable(luaState, -1) != 0) {
-                                        // stack: typeHashBucket | rootMetatable
-                                        lua_remove(luaState, -2);
-                                        // stack: rootMetatable
-                                        return false;
-                                    } else {
-                                        // stack: typeHashBucket | ?
-                                        throw UnexpectedStackException(luaState, __FILE__, __LINE__, __func__, "corrupted TypeManager: expected rootMetatable at index -1");
-                                    }
-                                }
-                            } else {
-                                // stack: typeHashBucket | ? | rootMetatable (?)
-                                throw UnexpectedStackException(luaState, __FILE__, __LINE__, __func__, "corrupted TypeManager: expected type_index_udata at index -2");
-                            }
-                            // stack: typeHashBucket | type_index_udata | rootMetatable (?)
-                        }
-                        // stack: typeHashBucket
-                        pushRootMetatableFromTypeHashBucketTable<T>(luaState, typeIndex);
-                        // stack: rootMetatable
-                    } else {
-                        // stack: typeManager | nil (?)
-                        lua_pop(luaState, 1);
-                        // stack: typeManager
-                        pushRootMetatableFromTypeManager<T>(luaState, typeIndex, typeHash);
                         // stack: rootMetatable
+                        return false;
+                    } else if (lua_isnil(luaState, -1) == 0) {
+                        // stack: typeManager | ?
+                        throw UnexpectedStackException(luaState, __FILE__, __LINE__, __func__, "corrupted TypeManager: expected rootMetatable at index -1");
                     }
+                    // stack: typeManager | nil
+                    lua_pop(luaState, 1);
+                    // stack: typeManager
+                    pushRootMetatableFromTypeManager<T>(luaState);
+                    // stack: rootMetatable
                 } else {
                     // stack: nil (?)
                     lua_pop(luaState, 1);
@@ -375,19 +481,33 @@ namespace integral {
                     // stack: typeManager | gkTypeManagerVersionKey | gkTypeManagerVersion
                     lua_rawset(luaState, -3);
                     // stack: typeManager
-                    pushRootMetatableFromTypeManager<T>(luaState, typeIndex, typeHash);
+                    pushRootMetatableFromTypeManager<T>(luaState);
                     // stack: rootMetatable
                 }
                 return true;
             }
 
             template<typename T>
-            inline void pushTypeIndexUserData(lua_State *luaState) {
-                pushTypeIndexUserData(luaState, typeid(T));
+            bool pushClassMetatable(lua_State *luaState) {
+                lua_compatibility::rawgetp(luaState, LUA_REGISTRYINDEX, TypeKey<UserDataType<T>>::get());
+                // stack: rootMetatable (?)
+                if (lua_istable(luaState, -1) != 0) {
+                    // stack: rootMetatable
+                    return false;
+                }
+                // stack: nil (?)
+                lua_pop(luaState, 1);
+                // stack:
+                const bool isNewMetatable = pushClassMetatableFromTypeManager<T>(luaState);
+                // stack: rootMetatable
+                lua_pushvalue(luaState, -1);
+                // stack: rootMetatable | rootMetatable
+                lua_compatibility::rawsetp(luaState, LUA_REGISTRYINDEX, TypeKey<UserDataType<T>>::get());
+                // stack: rootMetatable
+                return isNewMetatable;
             }
 
-            // metatable[gkTypeFunctionsKey] = {[typeHash] = {[type_index_udata] = typeFunction}}
-            // metatable[gkTypeFunctionsKey] = {[typeHash] = typeHashBucket}
+            // metatable[gkTypeFunctionsKey] = {[typeKey] = typeFunction}
             // metatable[gkTypeFunctionsKey] = typeFunctionTable
             template<typename D, typename B>
             void setTypeFunction(lua_State *luaState) {
@@ -395,25 +515,16 @@ namespace integral {
                 static_assert(std::is_same_v<std::remove_cv_t<B>, B> == true, "B is cv qualified");
                 static_assert(std::is_same_v<D, B> == false, "conversion to itself");
                 static_assert(std::is_base_of_v<B, D> == true, "D must be derived from B");
-                std::type_index typeIndex = typeid(B);
                 // stack: metatable
-                pushTypeFunctionHashTable(luaState, typeIndex);
-                // stack: metatable | typeHashBucket
-                pushTypeIndexUserData(luaState, typeIndex);
-                // stack: metatable | typeHashBucket | type_index_udata*
-                lua_pushcclosure(luaState, [](lua_State *lambdaLuaState) -> int {
-                    if (lua_islightuserdata(lambdaLuaState, 1) != 0) {
-                        // Attention! light userdata does not require alignment ajustment with basic::getAlignedObjectPointer
-                        lua_pushlightuserdata(lambdaLuaState, static_cast<void *>(static_cast<B *>(static_cast<D *>(lua_touserdata(lambdaLuaState, 1)))));
-                        return 1;
-                    } else {
-                        throw UnexpectedStackException(lambdaLuaState, __FILE__, __LINE__, __func__, "conversion function expected underlying lightuserdata");
-                    }
-                }, 0);
-                // stack: metatable | typeHashBucket | type_index_udata* | function*
-                lua_rawset(luaState, -3);
+                pushTypeFunctionTable(luaState, TypeKey<B>::get());
+                // stack: metatable | typeFunctionTable
+                pushTypeFunctionClosure(luaState, StaticTypeFunction<D, B>::keTypeFunction, false);
+                // stack: metatable | typeFunctionTable | function*
+                lua_compatibility::rawsetp(luaState, -2, TypeKey<B>::get());
+                // stack: metatable | typeFunctionTable
                 lua_pop(luaState, 1);
                 // stack: metatable
+                clearConversionPathCache(luaState);
             }
 
             template<typename F>
@@ -423,48 +534,29 @@ namespace integral {
                 using ConversionType = typename ConversionFunctionTraits::ConversionType;
                 static_assert(std::is_same_v<std::remove_cv_t<ConversionType>, ConversionType> == true, "ConversionType is cv qualified");
                 static_assert(std::is_same_v<std::remove_cv_t<OriginalType>, ConversionType> == false, "conversion to itself");
-                using ConversionFunctionType = std::function<ConversionType *(OriginalType *)>;
-                std::type_index typeIndex = typeid(ConversionType);
+                using CustomTypeFunctionType = CustomTypeFunction<OriginalType, ConversionType>;
                 // stack: metatable
-                pushTypeFunctionHashTable(luaState, typeIndex);
-                // stack: metatable | typeHashBucket
-                pushTypeIndexUserData(luaState, typeIndex);
-                // stack: metatable | typeHashBucket | type_index_udata*
-                basic::pushAlignedObject<ConversionFunctionType>(luaState, std::forward<F>(typeFunction));
-                // stack: metatable | typeHashBucket | type_index_udata* | typeFunction_udata_no_metatable
-                basic::pushClassMetatable<ConversionFunctionType>(luaState);
-                // stack: metatable | typeHashBucket | type_index_udata* | typeFunction_udata_no_metatable | typeFunction_udata_metatable
+                pushTypeFunctionTable(luaState, TypeKey<ConversionType>::get());
+                // stack: metatable | typeFunctionTable
+                basic::pushAlignedObject<CustomTypeFunctionType>(luaState, std::forward<F>(typeFunction));
+                // stack: metatable | typeFunctionTable | typeFunction_udata_no_metatable
+                basic::pushClassMetatable<CustomTypeFunctionType>(luaState);
+                // stack: metatable | typeFunctionTable | typeFunction_udata_no_metatable | typeFunction_udata_metatable
                 lua_setmetatable(luaState, -2);
-                // stack: metatable | typeHashBucket | type_index_udata* | typeFunction_udata
-                lua_pushcclosure(luaState, [](lua_State *lambdaLuaState) -> int {
-                    // no need for exception checking. Possible exceptions thrown by conversion function will be caught in [Lua]FunctionWrapperCaller. Type functions are only called by exchanger.
-                    if (lua_islightuserdata(lambdaLuaState, 1) != 0) {
-                        const ConversionFunctionType &conversionFunctionReference = *basic::getAlignedObjectPointer<ConversionFunctionType>(
-                            lambdaLuaState,
-                            lua_upvalueindex(1)
-                        );
-                        // Attention! light userdata does not require alignment ajustment with basic::getAlignedObjectPointer
-                        lua_pushlightuserdata(
-                            lambdaLuaState,
-                            static_cast<void *>(
-                                conversionFunctionReference(static_cast<OriginalType *>(lua_touserdata(lambdaLuaState, 1)))
-                            )
-                        );
-                        return 1;
-                    } else {
-                        throw UnexpectedStackException(lambdaLuaState, __FILE__, __LINE__, __func__, "custom conversion function expected underlying lightuserdata");
-                    }
-                }, 1);
-                // stack: metatable | typeHashBucket | type_index_udata* | function*
-                lua_rawset(luaState, -3);
-                // stack: metatable | typeHashBucket
+                // stack: metatable | typeFunctionTable | typeFunction_udata
+                // no need for exception checking. Possible exceptions thrown by conversion function will be caught in [Lua]FunctionWrapperCaller. Type functions are only called by exchanger.
+                pushTypeFunctionClosure(luaState, basic::getAlignedObjectPointer<CustomTypeFunctionType>(luaState, -1)->getTypeFunction(), true);
+                // stack: metatable | typeFunctionTable | function*
+                lua_compatibility::rawsetp(luaState, -2, TypeKey<ConversionType>::get());
+                // stack: metatable | typeFunctionTable
                 lua_pop(luaState, 1);
                 // stack: metatable
+                clearConversionPathCache(luaState);
             }
 
             template<typename D, typename B>
             void defineTypeFunction(lua_State *luaState) {
-                if (lua_istable(luaState, -1) != 0 && checkClassMetatableType(luaState, std::type_index(typeid(UserDataWrapper<D>))) == true) {
+                if (lua_istable(luaState, -1) != 0 && checkClassMetatableType(luaState, TypeKey<UserDataType<D>>::get()) == true) {
                     setTypeFunction<D, B>(luaState);
                 } else {
                     pushClassMetatable<D>(luaState);
@@ -477,7 +569,7 @@ namespace integral {
             void defineTypeFunction(lua_State *luaState, F &&typeFunction) {
                 using ConversionFunctionTraits = ConversionFunctionTraits<typename FunctionTraits<F>::Signature>;
                 using OriginalType = typename ConversionFunctionTraits::OriginalType;
-                if (lua_istable(luaState, -1) != 0 && checkClassMetatableType(luaState, std::type_index(typeid(UserDataWrapper<std::remove_cv_t<OriginalType>>))) == true) {
+                if (lua_istable(luaState, -1) != 0 && checkClassMetatableType(luaState, TypeKey<UserDataType<std::remove_cv_t<OriginalType>>>::get()) == true) {
                     setTypeFunction(luaState, std::forward<F>(typeFunction));
                 } else {
                     pushClassMetatable<std::remove_cv_t<OriginalType>>(luaState);
@@ -486,7 +578,7 @@ namespace integral {
                 }
             }
 
-            // metatable[gkUserDataWrapperBaseTableKey] = {userDataWrapperBaseTypeIndex, userDataWrapperBaseConversionFunction}
+            // metatable[gkUserDataWrapperBaseTableKey] = {userDataWrapperBaseTypeKey, userDataWrapperBaseConversionFunction}
             // metatable[gkUserDataWrapperBaseTableKey] = userDataWrapperBaseTable
             // provides conversion: UserDataWrapper<T> -> UserDataWrapperBase
             template<typename T>
@@ -496,9 +588,9 @@ namespace integral {
                 // stack: metatable | gkUserDataWrapperBaseTableKey
                 lua_createtable(luaState, 2, 0);
                 // stack: metatable | gkUserDataWrapperBaseTableKey | userDataWrapperBaseTable*
-                pushTypeIndexUserData<UserDataWrapperBase>(luaState);
-                // stack: metatable | gkUserDataWrapperBaseTableKey | userDataWrapperBaseTable* | userDataWrapperBaseTypeIndex*
-                lua_rawseti(luaState, -2, static_cast<lua_Integer>(UserDataWrapperBaseTable::kTypeIndexIndex));
+                lua_pushlightuserdata(luaState, TypeKey<UserDataWrapperBase>::get());
+                // stack: metatable | gkUserDataWrapperBaseTableKey | userDataWrapperBaseTable* | userDataWrapperBaseTypeKey
+                lua_rawseti(luaState, -2, static_cast<lua_Integer>(UserDataWrapperBaseTable::kTypeKeyIndex));
                 // stack: metatable | gkUserDataWrapperBaseTableKey | userDataWrapperBaseTable*
                 lua_pushcclosure(luaState, [](lua_State *lambdaLuaState) -> int {
                     lua_pushlightuserdata(
@@ -515,29 +607,14 @@ namespace integral {
             }
 
             template<typename T>
-            T * getConvertibleType(lua_State *luaState, int index) {
-                lua_pushvalue(luaState, index);
-                // stack: userdata
-                if (lua_getmetatable(luaState, -1) != 0) {
-                    // stack: userdata | metatable
-                    if (pushConvertibleOrInheritedType(luaState, -2, std::type_index(typeid(T)), false) == true) {
-                        // stack: userdata | typeTLightUserData
-                        // Attention! light userdata does not require alignment ajustment with basic::getAlignedObjectPointer
-                        T * lightUserData = static_cast<T *>(lua_touserdata(luaState, -1));
-                        lua_pop(luaState, 2);
-                        // stack:
-                        return lightUserData;
-                    } else {
-                        // stack: userdata
-                        lua_pop(luaState, 1);
-                        // stack:
-                    }
-                } else {
-                    // stack: userdata
-                    lua_pop(luaState, 1);
-                    // stack:
-                }
-                return nullptr;
+            inline T * getConvertibleType(lua_State *luaState, int index, bool &isConstantOffset) {
+                return static_cast<T *>(getConvertibleTypePointer(luaState, index, TypeKey<T>::get(), isConstantOffset));
+            }
+
+            template<typename T>
+            inline T * getConvertibleType(lua_State *luaState, int index) {
+                bool isConstantOffset;
+                return getConvertibleType<T>(luaState, index, isConstantOffset);
             }
 
             template<typename D, typename B>
@@ -570,7 +647,7 @@ namespace integral {
 
             template<typename D, typename B>
             void defineInheritance(lua_State *luaState) {
-                if (lua_istable(luaState, -1) != 0 && checkClassMetatableType(luaState, std::type_index(typeid(UserDataWrapper<D>))) == true) {
+                if (lua_istable(luaState, -1) != 0 && checkClassMetatableType(luaState, TypeKey<UserDataType<D>>::get()) == true) {
                     setInheritance<D, B>(luaState);
                 } else {
                     pushClassMetatable<D>(luaState);
@@ -583,7 +660,7 @@ namespace integral {
             void defineInheritance(lua_State *luaState, F &&typeFunction) {
                 using ConversionFunctionTraits = ConversionFunctionTraits<typename FunctionTraits<F>::Signature>;
                 using OriginalType = typename ConversionFunctionTraits::OriginalType;
-                if (lua_istable(luaState, -1) != 0 && checkClassMetatableType(luaState, std::type_index(typeid(UserDataWrapper<std::remove_cv_t<OriginalType>>))) == true) {
+                if (lua_istable(luaState, -1) != 0 && checkClassMetatableType(luaState, TypeKey<UserDataType<std::remove_cv_t<OriginalType>>>::get()) == true) {
                     setInheritance(luaState, std::forward<F>(typeFunction));
                 } else {
                     pushClassMetatable<std::remove_cv_t<OriginalType>>(luaState);
@@ -592,7 +669,52 @@ namespace integral {
                 }
             }
 
-            // metatable[gkInheritanceKey] = {[number] = {baseTypeIndex, baseMetatable}}
+            template<typename D, typename B>
+            void setFlattenedInheritance(lua_State *luaState) {
+                // stack: metatable
+                setInheritance<D, B>(luaState);
+                pushClassMetatable<B>(luaState);
+                // stack: metatable | baseMetatable
+                flattenInheritance(luaState);
+                // stack: metatable
+            }
+
+            template<typename F>
+            void setFlattenedInheritance(lua_State *luaState, F &&typeFunction) {
+                using ConversionType = typename ConversionFunctionTraits<typename FunctionTraits<F>::Signature>::ConversionType;
+                // stack: metatable
+                setInheritance(luaState, std::forward<F>(typeFunction));
+                pushClassMetatable<ConversionType>(luaState);
+                // stack: metatable | baseMetatable
+                flattenInheritance(luaState);
+                // stack: metatable
+            }
+
+            template<typename D, typename B>
+            void defineFlattenedInheritance(lua_State *luaState) {
+                if (lua_istable(luaState, -1) != 0 && checkClassMetatableType(luaState, TypeKey<UserDataType<D>>::get()) == true) {
+                    setFlattenedInheritance<D, B>(luaState);
+                } else {
+                    pushClassMetatable<D>(luaState);
+                    setFlattenedInheritance<D, B>(luaState);
+                    lua_pop(luaState, 1);
+                }
+            }
+
+            template<typename F>
+            void defineFlattenedInheritance(lua_State *luaState, F &&typeFunction) {
+                using ConversionFunctionTraits = ConversionFunctionTraits<typename FunctionTraits<F>::Signature>;
+                using OriginalType = typename ConversionFunctionTraits::OriginalType;
+                if (lua_istable(luaState, -1) != 0 && checkClassMetatableType(luaState, TypeKey<UserDataType<std::remove_cv_t<OriginalType>>>::get()) == true) {
+                    setFlattenedInheritance(luaState, std::forward<F>(typeFunction));
+                } else {
+                    pushClassMetatable<std::remove_cv_t<OriginalType>>(luaState);
+                    setFlattenedInheritance(luaState, std::forward<F>(typeFunction));
+                    lua_pop(luaState, 1);
+                }
+            }
+
+            // metatable[gkInheritanceKey] = {[number] = {baseTypeKey, baseMetatable}}
             // metatable[gkInheritanceKey] = {[number] = baseTable}
             // metatable[gkInheritanceKey] = inheritanceTable
             template<typename B>
@@ -614,7 +736,7 @@ namespace integral {
                     // stack: metatable | inheritanceTable* | gkInheritanceKey | inheritanceTable*
                     lua_rawset(luaState, -4);
                     // stack: metatable | inheritanceTable
-                } else if (checkInheritanceTable(luaState, std::type_index(typeid(B))) == true) {
+                } else if (checkInheritanceTable(luaState, TypeKey<B>::get()) == true) {
                     // stack: metatable | inheritanceTable
                     throw exception::LogicException(__FILE__, __LINE__, __func__, "trying to set existing inheritance");
                 }
@@ -627,9 +749,9 @@ namespace integral {
                 // stack: metatable | inheritanceTable | baseTable* | baseTableIndex | baseTable*
                 lua_rawset(luaState, -4);
                 // stack: metatable | inheritanceTable | baseTable
-                pushTypeIndexUserData<B>(luaState);
-                // stack: metatable | inheritanceTable | baseTable | baseTypeIndex*
-                lua_rawseti(luaState, -2, static_cast<lua_Integer>(InheritanceTable::kTypeIndexIndex));
+                lua_pushlightuserdata(luaState, TypeKey<B>::get());
+                // stack: metatable | inheritanceTable | baseTable | baseTypeKey
+                lua_rawseti(luaState, -2, static_cast<lua_Integer>(InheritanceTable::kTypeKeyIndex));
                 // stack: metatable | inheritanceTable | baseTable
                 pushClassMetatable<B>(luaState);
                 // stack: metatable | inheritanceTable | baseTable | baseMetatable*
@@ -637,6 +759,7 @@ namespace integral {
                 // stack: metatable | inheritanceTable | baseTable
                 lua_pop(luaState, 2);
                 // stack: metatable
+                clearConversionPathCache(luaState);
             }
         }
     }
@@ -31,7 +31,9 @@
 #include <functional>
 #include <memory>
 #include <optional>
+#include <stdexcept>
 #include <string>
+#include <string_view>
 #include <tuple>
 #include <unordered_map>
 #include <vector>
@@ -96,6 +98,26 @@ private:
     std::string id_;
 };
 
+class CompactVector final {
+public:
+    double x_;
+    double y_;
+
+    CompactVector(double x, double y) : x_(x), y_(y) {}
+
+    double getLength() const noexcept {
+        return std::sqrt(x_*x_ + y_*y_);
+    }
+};
+
+template<>
+class integral::CompactUserData<CompactVector> : public std::true_type {};
+
+class Constant {
+public:
+    const int value_ = 42;
+};
+
 Object makeObject(std::string_view id) {
     return std::string(id);
 }
@@ -104,6 +126,18 @@ double getSum(double x, double y) {
     return x + y;
 }
 
+double getProduct(double x, double y) noexcept {
+    return x*y;
+}
+
+integral::Returns<double, double> getMinimumAndMaximum(double x, double y) {
+    return {std::min(x, y), std::max(x, y)};
+}
+
+void throwRuntimeError() {
+    throw std::runtime_error("C++ exception");
+}
+
 void pushModule(lua_State *luaState) {
     integral::push<integral::Table>(luaState);
     integral::setFunction(
@@ -776,5 +810,699 @@ TEST_CASE("integral test") {
         stateView["global"]["y"] = integral::Global()["x"];
         REQUIRE_NOTHROW(stateView.doString("assert(global.x == y)"));
     }
+    SECTION("class metatable cache") {
+        stateView["object1"].set(Object("object1"));
+        stateView["Object"].set(integral::ClassMetatable<Object>());
+        stateView["object2"].set(Object("object2"));
+        REQUIRE_NOTHROW(stateView.doString("assert(getmetatable(object1) == Object)"));
+        REQUIRE_NOTHROW(stateView.doString("assert(getmetatable(object2) == Object)"));
+        REQUIRE(integral::detail::type_manager::pushClassMetatable<Object>(luaState.get()) == false);
+        REQUIRE_NOTHROW(stateView.doString("assert(getmetatable(object1) == Object)"));
+        lua_pop(luaState.get(), 1);
+    }
+    SECTION("getObject inline cache") {
+        stateView.defineInheritance<Object, BaseObject>();
+        stateView.defineInheritance([](Object *object) -> InnerObject * {
+            return &object->innerObject_;
+        });
+        integral::push<Object>(luaState.get(), "object1");
+        integral::push<Object>(luaState.get(), "object2");
+        integral::push<BaseObject>(luaState.get());
+        // the second iteration hits the cache
+        for (int i = 0; i < 2; ++i) {
+            Object &object1 = integral::get<Object>(luaState.get(), 1);
+            Object &object2 = integral::get<Object>(luaState.get(), 2);
+            REQUIRE(object1.getId() == "object1");
+            REQUIRE(object2.getId() == "object2");
+            REQUIRE(&integral::get<BaseObject>(luaState.get(), 1) == static_cast<BaseObject *>(&object1));
+            REQUIRE(&integral::get<BaseObject>(luaState.get(), 2) == static_cast<BaseObject *>(&object2));
+            REQUIRE(&integral::get<BaseObject>(luaState.get(), 3) != static_cast<BaseObject *>(&object2));
+#if INTEGRAL_WITH_RTTI
+            // dynamic_cast
+            REQUIRE(&integral::get<BaseOfBaseObject>(luaState.get(), 2) == static_cast<BaseOfBaseObject *>(&object2));
+#endif
+            // synthetic inheritance (not cached)
+            REQUIRE(&integral::get<InnerObject>(luaState.get(), 2) == &object2.innerObject_);
+            REQUIRE_THROWS_AS(integral::get<Object>(luaState.get(), 3), integral::ArgumentException);
+        }
+        lua_pop(luaState.get(), 3);
+    }
+    SECTION("conversion path cache") {
+        integral::push<Object>(luaState.get(), "object");
+        Object &cppObject = integral::get<Object>(luaState.get(), 1);
+        bool isConstantOffset;
+        // failed search is cached
+        REQUIRE(integral::detail::type_manager::getConvertibleType<InnerObject>(luaState.get(), 1) == nullptr);
+        REQUIRE(integral::detail::type_manager::getConvertibleType<InnerObject>(luaState.get(), 1) == nullptr);
+        // graph change clears the cache
+        stateView.defineInheritance([](Object *object) -> InnerObject * {
+            return &object->innerObject_;
+        });
+        stateView.defineInheritance<InnerObject, BaseOfInnerObject>();
+        for (int i = 0; i < 2; ++i) {
+            REQUIRE(integral::detail::type_manager::getConvertibleType<InnerObject>(luaState.get(), 1, isConstantOffset) == &cppObject.innerObject_);
+            REQUIRE(isConstantOffset == false);
+            REQUIRE(integral::detail::type_manager::getConvertibleType<BaseOfInnerObject>(luaState.get(), 1, isConstantOffset) == static_cast<BaseOfInnerObject *>(&cppObject.innerObject_));
+            REQUIRE(isConstantOffset == false);
+        }
+        REQUIRE(integral::detail::type_manager::getConvertibleType<BaseOfBaseObject>(luaState.get(), 1) == nullptr);
+        stateView.defineInheritance<BaseObject, BaseOfBaseObject>();
+        stateView.defineInheritance<Object, BaseObject>();
+        REQUIRE(integral::detail::type_manager::getConvertibleType<BaseOfBaseObject>(luaState.get(), 1, isConstantOffset) == static_cast<BaseOfBaseObject *>(&cppObject));
+        REQUIRE(isConstantOffset == true);
+        lua_pop(luaState.get(), 1);
+    }
+    SECTION("native conversion path") {
+        stateView.defineInheritance<BaseObject, BaseOfBaseObject>();
+        stateView.defineInheritance<Object, BaseObject>();
+        stateView.defineInheritance([](Object *object) -> InnerObject * {
+            return &object->innerObject_;
+        });
+        stateView.defineInheritance<InnerObject, BaseOfInnerObject>();
+        integral::push<Object>(luaState.get(), "object");
+        Object &cppObject = integral::get<Object>(luaState.get(), 1);
+        bool isConstantOffset;
+        lua_getmetatable(luaState.get(), 1);
+        integral::detail::type_manager::pushConversionPath(luaState.get(), integral::detail::TypeKey<BaseOfBaseObject>::get());
+        // integral type functions are native: the cached conversion path is a ConversionPath userdata
+        REQUIRE(lua_isuserdata(luaState.get(), -1) != 0);
+        lua_pop(luaState.get(), 2);
+        // applying the type function closures of the conversion path gives the same result
+        lua_newtable(luaState.get());
+        lua_getmetatable(luaState.get(), 1);
+        REQUIRE(integral::detail::type_manager::searchConversionPath(luaState.get(), integral::detail::TypeKey<BaseOfInnerObject>::get(), 2) == true);
+        REQUIRE(integral::detail::type_manager::applyConversionPathFunctions(luaState.get(), 1, isConstantOffset) == static_cast<BaseOfInnerObject *>(&cppObject.innerObject_));
+        REQUIRE(isConstantOffset == false);
+        lua_pop(luaState.get(), 1);
+        for (int i = 0; i < 2; ++i) {
+            REQUIRE(integral::detail::type_manager::getConvertibleType<BaseOfInnerObject>(luaState.get(), 1, isConstantOffset) == static_cast<BaseOfInnerObject *>(&cppObject.innerObject_));
+            REQUIRE(isConstantOffset == false);
+            // the second iteration uses the composed offset
+            REQUIRE(integral::detail::type_manager::getConvertibleType<BaseOfBaseObject>(luaState.get(), 1, isConstantOffset) == static_cast<BaseOfBaseObject *>(&cppObject));
+            REQUIRE(isConstantOffset == true);
+        }
+        lua_pop(luaState.get(), 1);
+    }
+    SECTION("flattened inheritance") {
+        stateView["BaseOfBaseObject"] = integral::ClassMetatable<BaseOfBaseObject>()
+                                            .setFunction("getBaseOfBaseString", &BaseOfBaseObject::getBaseOfBaseString);
+        stateView["BaseObject"] = integral::ClassMetatable<BaseObject>()
+                                      .setFunction("getBaseConstant", &BaseObject::getBaseConstant)
+                                      .setFunction("getId", [](const BaseObject &) -> std::string {
+                                          return "base";
+                                      })
+                                      .setFlattenedBaseClass<BaseOfBaseObject>();
+        stateView["Object"] = integral::ClassMetatable<Object>()
+                                  .setFunction("getId", &Object::getId)
+                                  .setFlattenedBaseClass<BaseObject>();
+        stateView["object"] = Object("object");
+        // base class methods are raw fields of the derived class metatable (through every level)
+        REQUIRE_NOTHROW(stateView.doString("assert(rawget(Object, 'getBaseConstant') == BaseObject.getBaseConstant)"));
+        REQUIRE_NOTHROW(stateView.doString("assert(rawget(Object, 'getBaseOfBaseString') == BaseOfBaseObject.getBaseOfBaseString)"));
+        REQUIRE_NOTHROW(stateView.doString("assert(object:getBaseConstant() == 42)"));
+        REQUIRE_NOTHROW(stateView.doString("assert(object:getBaseOfBaseString() == 'BaseOfBase')"));
+        // own fields are not overridden
+        REQUIRE_NOTHROW(stateView.doString("assert(object:getId() == 'object')"));
+        // fields added later to a base class metatable are propagated
+        REQUIRE_NOTHROW(stateView.doString("function BaseOfBaseObject.getNew(self) return 'new' end"));
+        REQUIRE_NOTHROW(stateView.doString("assert(rawget(BaseObject, 'getNew') ~= nil and rawget(Object, 'getNew') ~= nil)"));
+        REQUIRE_NOTHROW(stateView.doString("assert(object:getNew() == 'new')"));
+        stateView["BaseObject"]["getBaseConstant"].setFunction([](const BaseObject &) {
+            return 43;
+        });
+        REQUIRE_NOTHROW(stateView.doString("assert(object:getBaseConstant() == 43)"));
+        stateView["BaseObject"]["getId"] = 0;
+        REQUIRE_NOTHROW(stateView.doString("assert(object:getId() == 'object')"));
+        // integral internal fields are not flattened
+        REQUIRE_NOTHROW(stateView.doString("assert(rawget(Object, 'integral_TypeKeyKey') ~= rawget(BaseObject, 'integral_TypeKeyKey'))"));
+
+        // the flattened derived class metatables (lightuserdata key) are not flattened
+        stateView["BaseObject"].push();
+        integral::detail::lua_compatibility::rawgetp(luaState.get(), -1, integral::detail::TypeKey<integral::detail::type_manager::FlattenedDerived>::get());
+        REQUIRE(lua_istable(luaState.get(), -1) != 0);
+        lua_pop(luaState.get(), 2);
+        stateView["Object"].push();
+        integral::detail::lua_compatibility::rawgetp(luaState.get(), -1, integral::detail::TypeKey<integral::detail::type_manager::FlattenedDerived>::get());
+        REQUIRE(lua_isnil(luaState.get(), -1) != 0);
+        lua_pop(luaState.get(), 2);
+        // generic table writes (no metatable) are plain raw sets
+        stateView["flattenedGlobal"] = 1;
+        REQUIRE(stateView["flattenedGlobal"].get<int>() == 1);
+    }
+    SECTION("type keys") {
+        stateView.defineInheritance<Object, BaseObject>();
+        integral::push<Object>(luaState.get(), "object");
+        lua_getmetatable(luaState.get(), 1);
+        // class metatables are identified by lightuserdata type keys (no RTTI)
+        REQUIRE(integral::detail::type_manager::getClassMetatableType(luaState.get()) == integral::detail::TypeKey<integral::detail::UserDataWrapper<Object>>::get());
+        REQUIRE(integral::detail::type_manager::checkClassMetatableType(luaState.get(), integral::detail::TypeKey<integral::detail::UserDataWrapper<BaseObject>>::get()) == false);
+        REQUIRE(integral::detail::type_manager::checkClassMetatableExistence<Object>(luaState.get()) == true);
+        REQUIRE(integral::detail::type_manager::checkClassMetatableExistence(luaState.get(), integral::detail::TypeKey<integral::detail::UserDataWrapper<InnerObject>>::get()) == false);
+        REQUIRE(integral::detail::type_manager::pushTypeFunction(luaState.get(), integral::detail::TypeKey<BaseObject>::get()) == true);
+        REQUIRE(lua_iscfunction(luaState.get(), -1) != 0);
+        lua_pop(luaState.get(), 1);
+        REQUIRE(integral::detail::type_manager::pushTypeFunction(luaState.get(), integral::detail::TypeKey<InnerObject>::get()) == false);
+        REQUIRE_THROWS_AS((integral::detail::type_manager::setTypeFunction<Object, BaseObject>(luaState.get())), exception::LogicException);
+        lua_settop(luaState.get(), 0);
+    }
+#if INTEGRAL_WITH_RTTI
+    SECTION("memoized dynamic_cast") {
+        // Object -> BaseOfBaseObject is not defined: dynamic_cast fallback
+        integral::push<Object>(luaState.get(), "object");
+        Object &cppObject = integral::get<Object>(luaState.get(), 1);
+        bool isConstantOffset;
+        REQUIRE(integral::detail::type_manager::getConvertibleType<BaseOfBaseObject>(luaState.get(), 1) == nullptr);
+        REQUIRE(&integral::detail::exchanger::resolveObject<BaseOfBaseObject>(luaState.get(), 1, nullptr) == static_cast<BaseOfBaseObject *>(&cppObject));
+        lua_getmetatable(luaState.get(), 1);
+        integral::detail::type_manager::pushConversionPath(luaState.get(), integral::detail::TypeKey<BaseOfBaseObject>::get());
+        REQUIRE(lua_isuserdata(luaState.get(), -1) != 0);
+        lua_pop(luaState.get(), 2);
+        REQUIRE(integral::detail::type_manager::getConvertibleType<BaseOfBaseObject>(luaState.get(), 1, isConstantOffset) == static_cast<BaseOfBaseObject *>(&cppObject));
+        REQUIRE(isConstantOffset == true);
+        // the memoized offset is valid for every userdata with the same metatable
+        integral::push<Object>(luaState.get(), "object2");
+        REQUIRE(integral::detail::type_manager::getConvertibleType<BaseOfBaseObject>(luaState.get(), 2) == static_cast<BaseOfBaseObject *>(&integral::get<Object>(luaState.get(), 2)));
+        // defining inheritance clears the cache
+        stateView.defineInheritance<Object, BaseObject>();
+        REQUIRE(integral::detail::type_manager::getConvertibleType<BaseOfBaseObject>(luaState.get(), 1) == nullptr);
+        lua_pop(luaState.get(), 2);
+    }
+#endif
+    SECTION("compact userdata") {
+        stateView["CompactVector"].set(integral::ClassMetatable<CompactVector>()
+                                       .setConstructor<CompactVector(double, double)>("new")
+                                       .setFunction("getLength", &CompactVector::getLength)
+                                       .setGetter("getX", &CompactVector::x_)
+                                       .setSetter("setX", &CompactVector::x_)
+                                       );
+        REQUIRE_NOTHROW(stateView.doString("vector = CompactVector.new(3, 4)"));
+        REQUIRE_NOTHROW(stateView.doString("assert(vector:getLength() == 5)"));
+        REQUIRE_NOTHROW(stateView.doString("vector:setX(0); assert(vector:getX() == 0 and vector:getLength() == 4)"));
+        integral::push<CompactVector>(luaState.get(), 6.0, 8.0);
+        // the object is stored directly in the userdata block: no UserDataWrapper and no alignment padding
+        REQUIRE(lua_touserdata(luaState.get(), -1) == static_cast<void *>(&integral::get<CompactVector>(luaState.get(), -1)));
+        REQUIRE(integral::detail::lua_compatibility::rawlen(luaState.get(), -1) == sizeof(CompactVector));
+        REQUIRE(integral::get<CompactVector>(luaState.get(), -1).getLength() == 10.0);
+        lua_getmetatable(luaState.get(), -1);
+        REQUIRE(integral::detail::type_manager::getClassMetatableType(luaState.get()) == integral::detail::TypeKey<CompactVector>::get());
+        lua_pushstring(luaState.get(), "__gc");
+        lua_rawget(luaState.get(), -2);
+        REQUIRE(lua_isnil(luaState.get(), -1) != 0);
+        lua_pop(luaState.get(), 2);
+        REQUIRE_THROWS_AS(integral::get<Object>(luaState.get(), -1), integral::ArgumentException);
+        lua_pop(luaState.get(), 1);
+    }
+    SECTION("static functions") {
+        lua_newtable(luaState.get());
+        integral::setFunction<&getSum>(luaState.get(), "getSum");
+        integral::setFunction<&Object::getId>(luaState.get(), "getObjectId");
+        integral::pushFunction<&throwRuntimeError>(luaState.get());
+        // stateless lua_CFunction
+        REQUIRE(lua_iscfunction(luaState.get(), -1) != 0);
+        REQUIRE(lua_getupvalue(luaState.get(), -1, 1) == nullptr);
+        lua_setfield(luaState.get(), -2, "throwRuntimeError");
+        lua_setglobal(luaState.get(), "Static");
+        stateView["Object"].set(integral::ClassMetatable<Object>()
+                                .setConstructor<Object(const std::string &)>("new")
+                                .setFunction<&Object::getId>("getId")
+                                .setFunction<&Object::setId>("setId")
+                                );
+        stateView["group"].set(integral::Table().setFunction<&getSum>("getSum"));
+        stateView["getSum"].setFunction<&getSum>();
+        REQUIRE_NOTHROW(stateView.doString("assert(Static.getSum(1, 2) == 3)"));
+        REQUIRE_NOTHROW(stateView.doString("object = Object.new('id'); object:setId('static'); assert(Static.getObjectId(object) == 'static' and object:getId() == 'static')"));
+        REQUIRE_NOTHROW(stateView.doString("assert(group.getSum(2, 3) == 5 and getSum(3, 4) == 7)"));
+        REQUIRE_THROWS_AS(stateView.doString("Static.throwRuntimeError()"), integral::StateException);
+        REQUIRE_THROWS_AS(stateView.doString("Static.getSum(1, 2, 3)"), integral::StateException);
+        REQUIRE_THROWS_AS(stateView.doString("Static.getSum(1)"), integral::StateException);
+        REQUIRE_THROWS_AS(stateView.doString("Static.getObjectId(1)"), integral::StateException);
+    }
+    SECTION("LuaFunctionWrapper metatable cache") {
+        integral::pushLuaFunction(luaState.get(), [](lua_State *) -> int {
+            return 0;
+        });
+        integral::pushLuaFunction(luaState.get(), [](lua_State *lambdaLuaState) -> int {
+            integral::push<int>(lambdaLuaState, 42);
+            return 1;
+        });
+        // stack: function1 | function2
+        REQUIRE(lua_getupvalue(luaState.get(), 1, 1) != nullptr);
+        REQUIRE(lua_getmetatable(luaState.get(), -1) != 0);
+        REQUIRE(lua_getupvalue(luaState.get(), 2, 1) != nullptr);
+        REQUIRE(lua_getmetatable(luaState.get(), -1) != 0);
+        // stack: function1 | function2 | upvalue1 | metatable1 | upvalue2 | metatable2
+        REQUIRE(lua_rawequal(luaState.get(), 4, 6) != 0);
+        integral::detail::lua_compatibility::rawgetp(luaState.get(), LUA_REGISTRYINDEX, integral::detail::TypeKey<integral::detail::basic::NamedClassMetatableKey<integral::LuaFunctionWrapper>>::get());
+        REQUIRE(lua_rawequal(luaState.get(), 4, -1) != 0);
+        lua_settop(luaState.get(), 2);
+        lua_call(luaState.get(), 0, 1);
+        REQUIRE(integral::get<int>(luaState.get(), -1) == 42);
+        lua_pop(luaState.get(), 2);
+    }
+    SECTION("noexcept static functions") {
+        static_assert(integral::StaticFunctionWrapper<&getProduct>::keIsNoexcept == true);
+        static_assert(integral::StaticFunctionWrapper<&CompactVector::getLength>::keIsNoexcept == true);
+        static_assert(integral::StaticFunctionWrapper<&getSum>::keIsNoexcept == false);
+        static_assert(integral::StaticFunctionWrapper<&Object::getId>::keIsNoexcept == false);
+        stateView["getProduct"].setFunction<&getProduct>();
+        stateView["CompactVector"].set(integral::ClassMetatable<CompactVector>()
+                                       .setConstructor<CompactVector(double, double)>("new")
+                                       .setFunction<&CompactVector::getLength>("getLength")
+                                       );
+        REQUIRE_NOTHROW(stateView.doString("assert(getProduct(2, 3) == 6)"));
+        // InlineCache miss (regular conversion) and hit (fast path)
+        REQUIRE_NOTHROW(stateView.doString("vector = CompactVector.new(3, 4); assert(vector:getLength() == 5 and vector:getLength() == 5)"));
+        // invalid argument types raise Lua errors directly
+        REQUIRE_NOTHROW(stateView.doString("local ok, message = pcall(getProduct, 'x', 1); assert(ok == false and string.find(message, 'bad argument #1', 1, true) ~= nil)"));
+        REQUIRE_THROWS_AS(stateView.doString("getProduct(1, 2, 3)"), integral::StateException);
+        REQUIRE_THROWS_AS(stateView.doString("getProduct(1)"), integral::StateException);
+        REQUIRE_THROWS_AS(stateView.doString("CompactVector.getLength(1)"), integral::StateException);
+    }
+    SECTION("overload") {
+        stateView["Object"].set(integral::ClassMetatable<Object>()
+                                .setConstructor<Object(const std::string &)>("new")
+                                .set("id", integral::overload(&Object::getId, &Object::setId))
+                                );
+        stateView["describe"] = integral::overload(
+            [](const Object &object) {
+                return "object " + object.getId();
+            },
+            [](double number) {
+                return "number " + std::to_string(static_cast<int>(number));
+            },
+            [](const std::string &string) {
+                return "string " + string;
+            },
+            &getSum,
+            [] {
+                return std::string("none");
+            }
+        );
+        REQUIRE_NOTHROW(stateView.doString("assert(describe(1) == 'number 1' and describe('x') == 'string x' and describe() == 'none' and describe(1, 2) == 3)"));
+        // object arguments are tested with the type manager after the Lua type dispatch
+        REQUIRE_NOTHROW(stateView.doString("object = Object.new('id'); assert(describe(object) == 'object id')"));
+        REQUIRE_NOTHROW(stateView.doString("object:id('overload'); assert(object:id() == 'overload')"));
+        REQUIRE_NOTHROW(stateView.doString("local ok, message = pcall(describe, true); assert(ok == false and string.find(message, 'no matching overload', 1, true) ~= nil)"));
+        REQUIRE_THROWS_AS(stateView.doString("describe({})"), integral::StateException);
+        REQUIRE_THROWS_AS(stateView.doString("describe(1, 2, 3)"), integral::StateException);
+        REQUIRE_THROWS_AS(stateView.doString("Object.id(1)"), integral::StateException);
+    }
+    SECTION("multiple return values") {
+        stateView["getPosition"].setFunction([] {
+            return integral::Returns<double, double, double>(1.0, 2.0, 3.0);
+        });
+        stateView["getNamedObject"].setFunction([](const std::string &id) {
+            return integral::Returns<std::string, Object>(id, Object(id));
+        });
+        stateView["getMinimumAndMaximum"].setFunction<&getMinimumAndMaximum>();
+        stateView["getNothing"].setFunction([] {
+            return integral::Returns<>();
+        });
+        REQUIRE_NOTHROW(stateView.doString("local x, y, z = getPosition(); assert(x == 1 and y == 2 and z == 3 and select('#', getPosition()) == 3)"));
+        REQUIRE_NOTHROW(stateView.doString("id, object = getNamedObject('id'); assert(id == 'id' and type(object) == 'userdata')"));
+        REQUIRE(stateView["object"].get<Object>().getId() == "id");
+        REQUIRE_NOTHROW(stateView.doString("local minimum, maximum = getMinimumAndMaximum(2, 1); assert(minimum == 1 and maximum == 2)"));
+        REQUIRE_NOTHROW(stateView.doString("assert(select('#', getNothing()) == 0)"));
+        // std::tuple is still pushed as a table
+        stateView["getTuple"].setFunction([] {
+            return std::tuple<double, double>(1.0, 2.0);
+        });
+        REQUIRE_NOTHROW(stateView.doString("local tuple = getTuple(); assert(type(tuple) == 'table' and tuple[2] == 2)"));
+    }
+    SECTION("function call with multiple results") {
+        stateView["Object"].set(integral::ClassMetatable<Object>()
+                                .setConstructor<Object(const std::string &)>("new")
+                                );
+        REQUIRE_NOTHROW(stateView.doString("function getPosition(offset) return 1 + offset, 2 + offset, 3 + offset end"));
+        REQUIRE_NOTHROW(stateView.doString("function getNamedObject(id) return id, Object.new(id) end"));
+        const auto [x, y, z] = stateView["getPosition"].call<integral::Returns<double, double, double>>(1);
+        REQUIRE((x == 2.0 && y == 3.0 && z == 4.0));
+        const auto [id, object] = stateView["getNamedObject"].call<integral::Returns<std::string, Object>>("id");
+        REQUIRE((id == "id" && object.getId() == "id"));
+        lua_getglobal(luaState.get(), "getPosition");
+        REQUIRE(std::get<1>(integral::call<integral::Returns<int, int>>(luaState.get(), 0)) == 2);
+        // missing results are nil
+        REQUIRE_THROWS_AS((stateView["getNamedObject"].call<integral::Returns<std::string, Object, int>>("id")), integral::ReferenceException);
+        REQUIRE_NOTHROW(stateView["setLastPosition"].setFunction([](const integral::LuaFunctionArgument &function) {
+            return std::get<2>(function.call<integral::Returns<double, double, double>>(0.0));
+        }));
+        REQUIRE_NOTHROW(stateView.doString("assert(setLastPosition(getPosition) == 3)"));
+    }
+    SECTION("default arguments stored as upvalues") {
+        integral::pushFunction(luaState.get(), [](const Object &object, const std::string &suffix) {
+            return object.getId() + suffix;
+        }, integral::DefaultArgument<Object, 1>("shared"), integral::DefaultArgument<std::string, 2>("!"));
+        // stack: function
+        // upvalue 1 is the LuaFunctionWrapper userdata
+        REQUIRE(lua_getupvalue(luaState.get(), -1, 2) != nullptr);
+        REQUIRE(integral::get<Object>(luaState.get(), -1).getId() == "shared");
+        REQUIRE(lua_getupvalue(luaState.get(), -2, 3) != nullptr);
+        REQUIRE(integral::get<std::string>(luaState.get(), -1) == "!");
+        lua_pop(luaState.get(), 2);
+        lua_setglobal(luaState.get(), "getSharedId");
+        // non-const references are not shared: the function can not change the default argument
+        stateView["getChangedId"].setFunction([](Object &object) {
+            object.setId(object.getId() + "!");
+            return object.getId();
+        }, integral::DefaultArgument<Object, 1>("changed"));
+        REQUIRE_NOTHROW(stateView.doString("assert(getSharedId() == 'shared!' and getSharedId() == 'shared!' and getSharedId(nil, '?') == 'shared?')"));
+        REQUIRE_NOTHROW(stateView.doString("assert(getChangedId() == 'changed!' and getChangedId() == 'changed!')"));
+    }
+    SECTION("properties") {
+        stateView["Object"].set(integral::ClassMetatable<Object>()
+                                .setConstructor<Object(const std::string &)>("new")
+                                .setProperty<&Object::flag_>("flag")
+                                .setFunction<&Object::getId>("getId")
+                                );
+        stateView["CompactVector"].set(integral::ClassMetatable<CompactVector>()
+                                       .setConstructor<CompactVector(double, double)>("new")
+                                       .setProperty<&CompactVector::x_>("x")
+                                       .setProperty<&CompactVector::y_>("y")
+                                       );
+        stateView["Constant"].set(integral::ClassMetatable<Constant>()
+                                  .setConstructor<Constant()>("new")
+                                  .setProperty<&Constant::value_>("value")
+                                  );
+        REQUIRE_NOTHROW(stateView.doString("object = Object.new('id'); assert(object.flag == false); object.flag = true; assert(object.flag == true)"));
+        REQUIRE(stateView["object"].get<Object>().flag_ == true);
+        // names that are not properties are looked up as methods
+        REQUIRE_NOTHROW(stateView.doString("assert(object:getId() == 'id' and object.unknown == nil)"));
+        // class type members would be read as copies
+        static_assert(integral::detail::property::IsCopiedUserData<InnerObject>::value == true);
+        static_assert(integral::detail::property::IsCopiedUserData<const CompactVector>::value == true);
+        static_assert(integral::detail::property::IsCopiedUserData<std::shared_ptr<InnerObject>>::value == false);
+        static_assert(integral::detail::property::IsCopiedUserData<std::string>::value == false);
+        REQUIRE_NOTHROW(stateView.doString("vector = CompactVector.new(1, 2); vector.x = vector.x + vector.y; assert(vector.x == 3 and vector.y == 2)"));
+        REQUIRE_NOTHROW(stateView.doString("constant = Constant.new(); assert(constant.value == 42)"));
+        REQUIRE_THROWS_AS(stateView.doString("constant.value = 1"), integral::StateException);
+        REQUIRE_THROWS_AS(stateView.doString("object.unknown = 1"), integral::StateException);
+        REQUIRE_THROWS_AS(stateView.doString("object.flag = 'not a boolean'"), integral::StateException);
+        lua_newtable(luaState.get());
+        integral::setProperty<&Object::flag_>(luaState.get(), "flag");
+        lua_getfield(luaState.get(), -1, "__newindex");
+        REQUIRE(lua_iscfunction(luaState.get(), -1) != 0);
+        lua_pop(luaState.get(), 2);
+    }
+    SECTION("persistent reference") {
+        REQUIRE_NOTHROW(stateView.doString("game = {world = {update = function(x) return x + 1 end, count = 1}}"));
+        integral::PersistentReference update = stateView["game"]["world"]["update"].pin();
+        integral::PersistentReference count = stateView["game"]["world"]["count"].pin();
+        REQUIRE(update.getReferenceString().find("update") != std::string::npos);
+        REQUIRE(update.call<int>(1) == 2);
+        REQUIRE(count.get<int>() == 1);
+        REQUIRE(static_cast<int>(count) == 1);
+        // the pinned values do not depend on the path
+        REQUIRE_NOTHROW(stateView.doString("game = nil"));
+        REQUIRE(update.call<int>(2) == 3);
+        REQUIRE(count.isNil() == false);
+        count.set(42);
+        REQUIRE(count.get<int>() == 42);
+        count.set(std::optional<int>());
+        REQUIRE(count.isNil() == true);
+        count.set("foo");
+        REQUIRE(count.get<std::string>() == "foo");
+        integral::PersistentReference movedUpdate(std::move(update));
+        REQUIRE(movedUpdate.call<int>(3) == 4);
+        update = std::move(movedUpdate);
+        REQUIRE(update.call<int>(4) == 5);
+        REQUIRE_THROWS_AS(count.get<int>(), integral::ReferenceException);
+        REQUIRE_THROWS_AS(count.call<void>(), integral::ReferenceException);
+        REQUIRE(stateView["nothing"].pin().isNil() == true);
+        REQUIRE_THROWS_AS(stateView["game"]["world"].pin(), integral::ReferenceException);
+    }
+    SECTION("integral::LuaFunction") {
+        REQUIRE_NOTHROW(stateView.doString("function getSum(x, y) return x + y end"));
+        integral::LuaFunction<int(int, int)> getSum = stateView["getSum"].get<integral::LuaFunction<int(int, int)>>();
+        REQUIRE(getSum(1, 2) == 3);
+        std::function<int(int, int)> function = getSum;
+        REQUIRE(function(3, 4) == 7);
+        // the function is kept in the registry
+        REQUIRE_NOTHROW(stateView.doString("getSum = nil; collectgarbage()"));
+        REQUIRE(function(5, 6) == 11);
+        stateView["storedGetSum"] = getSum;
+        REQUIRE_NOTHROW(stateView.doString("assert(storedGetSum(1, 1) == 2)"));
+        std::function<std::string(const std::string &)> callback;
+        stateView["setCallback"].setFunction([&callback](integral::LuaFunction<std::string(const std::string &)> luaFunction) {
+            callback = std::move(luaFunction);
+        });
+        REQUIRE_NOTHROW(stateView.doString("setCallback(function(s) return s .. '!' end)"));
+        REQUIRE(callback("hello") == "hello!");
+        // the main thread is kept: the coroutine the function is gotten from is collected
+        REQUIRE_NOTHROW(stateView.doString("local co = coroutine.create(function() setCallback(function(s) return s .. '?' end) end); assert(coroutine.resume(co)); co = nil; collectgarbage()"));
+        REQUIRE(callback("hello") == "hello?");
+        REQUIRE_NOTHROW(stateView.doString("callable = setmetatable({}, {__call = function(self, x, y) return x*y end})"));
+        REQUIRE(stateView["callable"].get<integral::LuaFunction<int(int, int)>>()(2, 3) == 6);
+        REQUIRE_THROWS_AS(stateView.doString("setCallback(42)"), integral::StateException);
+        REQUIRE_THROWS_AS(stateView["storedGetSum"].get<integral::LuaFunction<int(int)>>()(1), integral::CallerException);
+        REQUIRE_NOTHROW(stateView.doString("function getName() return 'name' end"));
+        REQUIRE_THROWS_AS(stateView["getName"].get<integral::LuaFunction<int()>>()(), integral::ArgumentException);
+    }
+    SECTION("integral::LuaFunctionArgument::callUnprotected") {
+        stateView["apply"].setFunction([](const integral::LuaFunctionArgument &function, int x) {
+            return function.callUnprotected<int>(x);
+        });
+        stateView["applyTwice"].setFunction([](const integral::LuaFunctionArgument &function, int x) {
+            return function.callUnprotected<integral::Returns<int, int>>(x, x);
+        });
+        stateView["run"].setFunction([](const integral::LuaFunctionArgument &function) {
+            function.callUnprotected<void>();
+        });
+        REQUIRE_NOTHROW(stateView.doString("assert(apply(function(x) return 2*x end, 21) == 42)"));
+        REQUIRE_NOTHROW(stateView.doString("local x, y = applyTwice(function(x, y) return x + 1, y + 2 end, 1); assert(x == 2 and y == 3)"));
+        REQUIRE_NOTHROW(stateView.doString("ran = false; run(function() ran = true end); assert(ran == true)"));
+        // lua errors propagate natively (the error value is not converted)
+        REQUIRE_NOTHROW(stateView.doString("local ok, message = pcall(apply, function() error({code = 42}) end, 1); assert(ok == false and message.code == 42)"));
+        REQUIRE_THROWS_AS(stateView.doString("apply(function() return 'x' end, 1)"), integral::StateException);
+        // the C++ frames are unwound before the error is raised again (std::string argument)
+        stateView["concatenate"].setFunction([](const integral::LuaFunctionArgument &function, const std::string &string) {
+            return function.callUnprotected<std::string>(string + string);
+        });
+        REQUIRE_NOTHROW(stateView.doString("assert(concatenate(function(s) return s .. '!' end, 'a') == 'aa!')"));
+        REQUIRE_NOTHROW(stateView.doString("local ok, message = pcall(concatenate, function() error('unprotected', 0) end, 'a'); assert(ok == false and message == 'unprotected')"));
+        REQUIRE(lua_gettop(luaState.get()) == 0);
+    }
+    SECTION("lazy integral::ArgumentException message") {
+        lua_pushstring(luaState.get(), "x");
+        try {
+            integral::get<int>(luaState.get(), -1);
+            FAIL("integral::ArgumentException expected");
+        } catch (const integral::ArgumentException &argumentException) {
+            // the type is captured when the exception is thrown
+            lua_pop(luaState.get(), 1);
+            lua_pushnumber(luaState.get(), 1.0);
+            REQUIRE(std::string(argumentException.what()) == "bad argument #-1 (number expected, got string)");
+            const integral::ArgumentException copy = argumentException;
+            REQUIRE(copy.what() == argumentException.what());
+        }
+        lua_pop(luaState.get(), 1);
+        REQUIRE_NOTHROW(stateView.doString("vector = {1, 'x'}"));
+        try {
+            stateView["vector"].get<std::vector<int>>();
+            FAIL("integral::ReferenceException expected");
+        } catch (const integral::ReferenceException &referenceException) {
+            REQUIRE(std::string(referenceException.what()).find("invalid table - std::vector - element: bad argument #-1 (number expected, got string)") != std::string::npos);
+        }
+        stateView["getSum"].setFunction([](int x, int y) {
+            return x + y;
+        });
+        REQUIRE_NOTHROW(stateView.doString("local ok, message = pcall(getSum, 1, 'y'); assert(ok == false and string.find(message, 'bad argument #2', 1, true) ~= nil and string.find(message, '(number expected, got string)', 1, true) ~= nil)"));
+
+        // the exception does not keep the lua state: what() is valid after the state is closed
+        try {
+            integral::State temporaryState;
+            lua_pushboolean(temporaryState.getLuaState(), 1);
+            integral::get<int>(temporaryState.getLuaState(), -1);
+            FAIL("integral::ArgumentException expected");
+        } catch (const integral::ArgumentException &argumentException) {
+            REQUIRE(std::string(argumentException.what()) == "bad argument #-1 (number expected, got boolean)");
+        }
+    }
+    SECTION("numeric std::vector and std::array") {
+        std::vector<double> doubles(1000);
+        for (std::size_t i = 0; i < doubles.size(); ++i) {
+            doubles[i] = 0.5*static_cast<double>(i);
+        }
+        stateView["doubles"] = doubles;
+        REQUIRE_NOTHROW(stateView.doString("assert(#doubles == 1000 and doubles[1] == 0 and doubles[1000] == 499.5)"));
+        REQUIRE(stateView["doubles"].get<std::vector<double>>() == doubles);
+        stateView["integers"] = std::array<int, 3>{-1, 0, 1};
+        REQUIRE_NOTHROW(stateView.doString("assert(#integers == 3 and integers[1] == -1 and integers[3] == 1)"));
+        REQUIRE((stateView["integers"].get<std::array<int, 3>>() == std::array<int, 3>{-1, 0, 1}));
+        REQUIRE_NOTHROW(stateView.doString("unsigneds = {1, 2, 3}; empty = {}"));
+        REQUIRE((stateView["unsigneds"].get<std::vector<unsigned>>() == std::vector<unsigned>{1, 2, 3}));
+        REQUIRE(stateView["empty"].get<std::vector<float>>().empty() == true);
+        REQUIRE_NOTHROW(stateView.doString("invalid = {1, 2, 'x'}"));
+        REQUIRE_THROWS_AS(stateView["invalid"].get<std::vector<double>>(), integral::ReferenceException);
+        REQUIRE_THROWS_AS((stateView["invalid"].get<std::array<int, 3>>()), integral::ReferenceException);
+        stateView["getSum"].setFunction([](const std::vector<double> &values) {
+            double sum = 0.0;
+            for (double value : values) {
+                sum += value;
+            }
+            return sum;
+        });
+        REQUIRE_NOTHROW(stateView.doString("assert(getSum({1, 2, 3.5}) == 6.5)"));
+        REQUIRE_NOTHROW(stateView.doString("local ok, message = pcall(getSum, {1, true}); assert(ok == false and string.find(message, 'std::vector - element', 1, true) ~= nil)"));
+    }
+    SECTION("integral::ContainerView") {
+        std::vector<double> vector{1.0, 2.0, 3.0};
+        stateView["vector"] = integral::ContainerView(vector);
+        REQUIRE_NOTHROW(stateView.doString("assert(#vector == 3 and vector[1] == 1 and vector[3] == 3 and vector[4] == nil)"));
+        REQUIRE_NOTHROW(stateView.doString("vector[1] = 10; vector[#vector + 1] = 4; vector:push_back(5)"));
+        REQUIRE((vector == std::vector<double>{10.0, 2.0, 3.0, 4.0, 5.0}));
+        REQUIRE_NOTHROW(stateView.doString("vector:erase(2)"));
+        REQUIRE((vector == std::vector<double>{10.0, 3.0, 4.0, 5.0}));
+        REQUIRE_NOTHROW(stateView.doString("local sum = 0; for i, value in ipairs(vector) do sum = sum + i*value end; assert(sum == 10 + 6 + 12 + 20)"));
+        REQUIRE_NOTHROW(stateView.doString("local n = 0; for i, value in pairs(vector) do n = n + 1; assert(vector[i] == value) end; assert(n == 4)"));
+        REQUIRE_THROWS_AS(stateView.doString("vector[10] = 1"), integral::StateException);
+        REQUIRE_THROWS_AS(stateView.doString("vector[1] = 'x'"), integral::StateException);
+        // copy through automatic inheritance
+        REQUIRE((stateView["vector"].get<std::vector<double>>() == vector));
+        std::shared_ptr<std::unordered_map<std::string, int>> unorderedMap = std::make_shared<std::unordered_map<std::string, int>>();
+        (*unorderedMap)["a"] = 1;
+        stateView["map"] = integral::ContainerView(unorderedMap);
+        unorderedMap.reset();
+        REQUIRE_NOTHROW(stateView.doString("assert(map.a == 1 and map.b == nil and #map == 1); map.b = 2; map.a = nil"));
+        REQUIRE_NOTHROW(stateView.doString("local n = 0; for key, value in pairs(map) do n = n + 1; assert(key == 'b' and value == 2) end; assert(n == 1)"));
+        REQUIRE_NOTHROW(stateView.doString("map.c = 3; map:erase('b'); assert(map.b == nil and map.c == 3)"));
+        REQUIRE(stateView["map"].get<integral::ContainerView<std::unordered_map<std::string, int>>>().get().size() == 1);
+        std::array<int, 2> array{1, 2};
+        stateView["array"] = integral::ContainerView(array);
+        REQUIRE_NOTHROW(stateView.doString("array[2] = array[1] + array[2]; assert(#array == 2 and array.push_back == nil)"));
+        REQUIRE(array[1] == 3);
+        REQUIRE_THROWS_AS(stateView.doString("array[3] = 1"), integral::StateException);
+        stateView["getSum"].setFunction([](const integral::ContainerView<std::vector<double>> &containerView) {
+            double sum = 0.0;
+            for (double value : containerView.get()) {
+                sum += value;
+            }
+            return sum;
+        });
+        REQUIRE_NOTHROW(stateView.doString("assert(getSum(vector) == 22)"));
+        REQUIRE_NOTHROW(stateView.doString("vector = nil; map = nil; array = nil; collectgarbage()"));
+    }
+    SECTION("integral::TableView") {
+        stateView["getSum"].setFunction([](const integral::TableView<> &tableView) {
+            double sum = 0.0;
+            for (std::size_t i = 1; i <= tableView.size(); ++i) {
+                sum += tableView.get<double>(i);
+            }
+            return sum;
+        });
+        REQUIRE_NOTHROW(stateView.doString("assert(getSum({1, 2, 3.5}) == 6.5 and getSum({}) == 0)"));
+        REQUIRE_THROWS_AS(stateView.doString("getSum(1)"), integral::StateException);
+        REQUIRE_NOTHROW(stateView.doString("local ok, message = pcall(getSum, {1, 'x'}); assert(ok == false)"));
+        stateView["getValue"].setFunction([](const integral::TableView<> &tableView, const std::string &key) {
+            return tableView.get<int>(key);
+        });
+        REQUIRE_NOTHROW(stateView.doString("assert(getValue({a = 1, b = 2}, 'b') == 2)"));
+        stateView["getKeys"].setFunction([](const integral::TableView<std::string, int> &tableView) {
+            std::string keys;
+            int sum = 0;
+            for (const auto &[key, value] : tableView) {
+                keys += key;
+                sum += value;
+            }
+            return keys.size() == 3 && sum == 6;
+        });
+        REQUIRE_NOTHROW(stateView.doString("assert(getKeys({x = 1, y = 2, z = 3}) == true)"));
+        stateView["getCount"].setFunction([](const integral::TableView<> &tableView) {
+            int count = 0;
+            for (auto entry : tableView) {
+                // number keys are converted from a copy: the traversal is not corrupted
+                if (entry.getKey<std::string>().empty() == false && entry.getValue<bool>() == true) {
+                    ++count;
+                }
+            }
+            return count;
+        });
+        REQUIRE_NOTHROW(stateView.doString("assert(getCount({true, true, a = true, b = false}) == 3)"));
+        stateView["findFirst"].setFunction([](const integral::TableView<int, int> &tableView, int target) {
+            // early exit: the iterator pops the key and the value
+            for (const auto &[key, value] : tableView) {
+                if (value == target) {
+                    return key;
+                }
+            }
+            return 0;
+        });
+        REQUIRE_NOTHROW(stateView.doString("assert(findFirst({5, 6, 7}, 6) == 2 and findFirst({5}, 6) == 0)"));
+        REQUIRE_NOTHROW(stateView.doString("t = {4, 5}"));
+        stateView["t"].push();
+        {
+            integral::TableView<> tableView = integral::get<integral::TableView<>>(luaState.get(), -1);
+            REQUIRE(tableView.size() == 2);
+            REQUIRE(tableView.get<int>(2) == 5);
+            REQUIRE(lua_gettop(luaState.get()) == 1);
+        }
+        lua_pop(luaState.get(), 1);
+    }
+    SECTION("std::string_view argument and integral::Reference::with") {
+        const std::string longString(100, 'x');
+        stateView["longString"] = longString;
+        stateView["getLength"].setFunction([](std::string_view string) {
+            return string.size();
+        });
+        REQUIRE_NOTHROW(stateView.doString("assert(getLength(longString) == 100 and getLength('a\\0b') == 3 and getLength(42) == 2)"));
+        REQUIRE_THROWS_AS(stateView.doString("getLength({})"), integral::StateException);
+        REQUIRE(stateView["longString"].with<std::string_view>([&longString](std::string_view string) {
+            return string == longString;
+        }) == true);
+        REQUIRE(stateView["longString"].with<const char *>([](const char *string) {
+            return std::string_view(string).size();
+        }) == 100);
+        bool isCalled = false;
+        stateView["longString"].with<std::string_view>([&isCalled](std::string_view string) {
+            isCalled = string.empty() == false;
+        });
+        REQUIRE(isCalled == true);
+        REQUIRE(lua_gettop(luaState.get()) == 0);
+        REQUIRE_THROWS_AS(stateView["getLength"].with<std::string_view>([](std::string_view) {}), integral::ReferenceException);
+        REQUIRE(lua_gettop(luaState.get()) == 0);
+        REQUIRE_THROWS_AS(stateView["longString"].with<std::string_view>([](std::string_view) {
+            throw std::runtime_error("with");
+        }), std::runtime_error);
+        REQUIRE(lua_gettop(luaState.get()) == 0);
+        integral::PersistentReference persistentReference = stateView["longString"].pin();
+        REQUIRE(persistentReference.with<std::string_view>([](std::string_view string) {
+            return string.size();
+        }) == 100);
+    }
+    SECTION("integral::Key") {
+        const integral::Key xKey(luaState.get(), "x");
+        const integral::Key getIdKey(luaState.get(), "getId");
+        REQUIRE(xKey.getName() == "x");
+        REQUIRE(lua_gettop(luaState.get()) == 0);
+        stateView[xKey] = 42;
+        REQUIRE_NOTHROW(stateView.doString("assert(x == 42)"));
+        REQUIRE(stateView[xKey].get<int>() == 42);
+        stateView["t"] = integral::Table().set(xKey, 1).set("y", 2);
+        REQUIRE_NOTHROW(stateView.doString("assert(t.x == 1 and t.y == 2)"));
+        REQUIRE(stateView["t"][xKey].get<int>() == 1);
+        // copies share the registry slot
+        const integral::Key xKeyCopy = xKey;
+        stateView["t"][xKeyCopy] = 3;
+        REQUIRE_NOTHROW(stateView.doString("assert(t.x == 3)"));
+        stateView["Object"].set(integral::ClassMetatable<Object>()
+                                .setConstructor<Object(const std::string &)>("new")
+                                .setFunction(getIdKey, &Object::getId));
+        REQUIRE_NOTHROW(stateView.doString("assert(Object.new('id'):getId() == 'id')"));
+        const std::string referenceString = stateView["t"][xKey]["z"].getReferenceString();
+        REQUIRE(referenceString.find("[\"x\"][\"z\"]") != std::string::npos);
+        REQUIRE_THROWS_AS(stateView["t"][xKey]["z"].get<int>(), integral::ReferenceException);
+        // keys are interned by name: repeated construction reuses the registry slot
+        for (int i = 0; i < 100; ++i) {
+            REQUIRE(stateView["t"][integral::Key(luaState.get(), "x")].get<int>() == 3);
+        }
+        integral::detail::lua_compatibility::rawgetp(luaState.get(), LUA_REGISTRYINDEX, integral::detail::TypeKey<integral::Key>::get());
+        int numberOfKeys = 0;
+        lua_pushnil(luaState.get());
+        while (lua_next(luaState.get(), -2) != 0) {
+            ++numberOfKeys;
+            lua_pop(luaState.get(), 1);
+        }
+        lua_pop(luaState.get(), 1);
+        REQUIRE(numberOfKeys == 2);
+    }
     REQUIRE(lua_gettop(luaState.get()) == 0);
 }